@@ -0,0 +1,78 @@
+#ifndef DUI_ANIMATION_HPP_
+#define DUI_ANIMATION_HPP_
+
+#include <string>
+#include <SDL.h>
+
+namespace dui {
+
+/**
+ * @brief How an animated value moves from its start to its end
+ * @see State.animate()
+ */
+enum class Easing
+{
+  LINEAR,      ///< Constant speed
+  EASE_IN,     ///< Starts slow
+  EASE_OUT,    ///< Ends slow
+  EASE_IN_OUT, ///< Starts and ends slow
+};
+
+/**
+ * @brief Apply the easing to a linear progress
+ *
+ * @param easing the easing
+ * @param t the progress, from 0 to 1
+ * @return double the eased progress, from 0 to 1
+ */
+constexpr double
+ease(Easing easing, double t)
+{
+  switch (easing) {
+  case Easing::EASE_IN:
+    return t * t * t;
+  case Easing::EASE_OUT:
+    t = 1 - t;
+    return 1 - t * t * t;
+  case Easing::EASE_IN_OUT:
+    if (t < .5) {
+      return 4 * t * t * t;
+    }
+    t = 2 - 2 * t;
+    return 1 - t * t * t / 2;
+  default:
+    return t;
+  }
+}
+
+/**
+ * @brief An animated value, stored on State
+ *
+ */
+struct Tween
+{
+  std::string key;  ///< The element qualified id
+  double from;      ///< Value at start
+  double to;        ///< Value at end
+  Uint32 start;     ///< Ticks at start
+  Uint32 duration;  ///< Duration in milliseconds
+  Easing easing;    ///< The easing
+  Uint32 lastFrame; ///< Last frame it was used
+  Uint32 lastTicks; ///< Ticks of the last frame it was used
+
+  /// If it reached the end
+  bool finished(Uint32 ticks) const { return ticks - start >= duration; }
+
+  /// The value at the given ticks
+  double valueAt(Uint32 ticks) const
+  {
+    if (finished(ticks)) {
+      return to;
+    }
+    return from + (to - from) * ease(easing, double(ticks - start) / duration);
+  }
+};
+
+} // namespace dui
+
+#endif // DUI_ANIMATION_HPP_
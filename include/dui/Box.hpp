@@ -1,6 +1,7 @@
 #ifndef DUI_BOX_HPP_
 #define DUI_BOX_HPP_
 
+#include <algorithm>
 #include <SDL.h>
 #include "BoxStyle.hpp"
 #include "EdgeSize.hpp"
@@ -51,10 +52,84 @@ textureBox(Target target, SDL_Texture* texture, SDL_Rect rect)
   state.display(Shape::Texture(rect, texture));
 }
 
+/**
+ * @brief adds connected line segments to target
+ * @ingroup elements
+ *
+ * They are drawn with a single render call, so prefer it to many thin
+ * colorBox() for lines and links.
+ *
+ * @param target the parent group or frame
+ * @param points the local points, at least 2
+ * @param count the number of points
+ * @param c the line color
+ */
+inline void
+polyline(Target target, const SDL_Point* points, size_t count, SDL_Color c)
+{
+  auto& state = target.getState();
+  SDL_assert(state.isInFrame());
+  SDL_assert(!target.isLocked());
+  if (count == 0) {
+    return;
+  }
+  auto caret = target.getCaret();
+  SDL_Point bottomRight = points[0];
+  for (size_t i = 1; i < count; ++i) {
+    bottomRight.x = std::max(bottomRight.x, points[i].x);
+    bottomRight.y = std::max(bottomRight.y, points[i].y);
+  }
+  target.advance({bottomRight.x + 1, bottomRight.y + 1});
+  state.displayPolyline(points, count, c, caret);
+}
+
+/**
+ * @brief Adds a single part of a box
+ *
+ * You probably want box() instead of this.
+ *
+ * @param target the box group
+ * @param r the box local position and size
+ * @param style
+ * @param part the part
+ */
+inline void
+boxPart(Target target, const SDL_Rect& r, const BoxStyle& style, BoxPart part)
+{
+  auto& sz = style.border;
+  auto& c = style.paint.border;
+  switch (part) {
+  case BoxPart::TOP:
+    colorBox(target, {r.x + 1, r.y, r.w - 2, sz.top}, c.top);
+    break;
+  case BoxPart::LEFT:
+    colorBox(target, {r.x, r.y + 1, sz.left, r.h - 2}, c.left);
+    break;
+  case BoxPart::BOTTOM:
+    colorBox(
+      target, {r.x + 1, r.y + r.h - sz.bottom, r.w - 2, sz.bottom}, c.bottom);
+    break;
+  case BoxPart::RIGHT:
+    colorBox(
+      target, {r.x + r.w - sz.right, r.y + 1, sz.right, r.h - 2}, c.right);
+    break;
+  default:
+    colorBox(target,
+             {r.x + sz.right,
+              r.y + sz.top,
+              r.w - sz.right - sz.left,
+              r.h - sz.top - sz.bottom},
+             style.paint.background);
+    break;
+  }
+}
+
 /**
  * @brief A stylizable box
  * @ingroup elements
  *
+ * Invisible parts, with zero width or transparent colors, are left out.
+ *
  * @param target the parent group or frame
  * @param r the box local position and size
  * @param style
@@ -62,23 +137,53 @@ textureBox(Target target, SDL_Texture* texture, SDL_Rect rect)
 inline void
 box(Target target, const SDL_Rect& r, const BoxStyle& style = themeFor<Box>())
 {
-  auto c = style.paint.background;
-  auto e = style.paint.border.right;
-  auto n = style.paint.border.top;
-  auto w = style.paint.border.left;
-  auto s = style.paint.border.bottom;
-  auto esz = style.border.right;
-  auto nsz = style.border.top;
-  auto wsz = style.border.left;
-  auto ssz = style.border.bottom;
+  if (!isVisible(style)) {
+    target.advance({r.x + r.w, r.y + r.h});
+    return;
+  }
   auto g = group(target, {}, {0}, Layout::NONE);
-  colorBox(g, {r.x + 1, r.y, r.w - 2, nsz}, {n.r, n.g, n.b, n.a});
-  colorBox(g, {r.x, r.y + 1, wsz, r.h - 2}, {w.r, w.g, w.b, w.a});
-  colorBox(g, {r.x + 1, r.y + r.h - ssz, r.w - 2, ssz}, {s.r, s.g, s.b, s.a});
-  colorBox(g, {r.x + r.w - esz, r.y + 1, esz, r.h - 2}, {e.r, e.g, e.b, e.a});
-  colorBox(g,
-           {r.x + esz, r.y + nsz, r.w - esz - wsz, r.h - nsz - ssz},
-           {c.r, c.g, c.b, c.a});
+  // The whole box, as the invisible parts must not change its size
+  Target(g).advance({r.x + r.w, r.y + r.h});
+  for (auto part : {BoxPart::TOP,
+                    BoxPart::LEFT,
+                    BoxPart::BOTTOM,
+                    BoxPart::RIGHT,
+                    BoxPart::BACKGROUND}) {
+    if (isVisible(style, part)) {
+      boxPart(g, r, style, part);
+    }
+  }
+}
+
+/// @copydoc box()
+/// @ingroup elements
+/// The invisible parts are left out at compile time.
+template<class SOURCE>
+inline void
+box(Target target, const SDL_Rect& r, StaticStyle<SOURCE>)
+{
+  constexpr BoxStyle style = SOURCE::get();
+  if constexpr (!isVisible(style)) {
+    target.advance({r.x + r.w, r.y + r.h});
+  } else {
+    auto g = group(target, {}, {0}, Layout::NONE);
+    Target(g).advance({r.x + r.w, r.y + r.h});
+    if constexpr (isVisible(style, BoxPart::TOP)) {
+      boxPart(g, r, style, BoxPart::TOP);
+    }
+    if constexpr (isVisible(style, BoxPart::LEFT)) {
+      boxPart(g, r, style, BoxPart::LEFT);
+    }
+    if constexpr (isVisible(style, BoxPart::BOTTOM)) {
+      boxPart(g, r, style, BoxPart::BOTTOM);
+    }
+    if constexpr (isVisible(style, BoxPart::RIGHT)) {
+      boxPart(g, r, style, BoxPart::RIGHT);
+    }
+    if constexpr (isVisible(style, BoxPart::BACKGROUND)) {
+      boxPart(g, r, style, BoxPart::BACKGROUND);
+    }
+  }
 }
 
 } // namespace dui
@@ -78,6 +78,44 @@ struct BoxStyle
   }
 };
 
+/// The parts of a box(), in the order they are added
+enum class BoxPart : Uint8
+{
+  TOP,
+  LEFT,
+  BOTTOM,
+  RIGHT,
+  BACKGROUND,
+};
+
+/// True if the style draws anything on the given part
+constexpr bool
+isVisible(const BoxStyle& style, BoxPart part)
+{
+  switch (part) {
+  case BoxPart::TOP:
+    return style.border.top > 0 && style.paint.border.top.a > 0;
+  case BoxPart::LEFT:
+    return style.border.left > 0 && style.paint.border.left.a > 0;
+  case BoxPart::BOTTOM:
+    return style.border.bottom > 0 && style.paint.border.bottom.a > 0;
+  case BoxPart::RIGHT:
+    return style.border.right > 0 && style.paint.border.right.a > 0;
+  default:
+    return style.paint.background.a > 0;
+  }
+}
+
+/// True if the style draws anything at all
+constexpr bool
+isVisible(const BoxStyle& style)
+{
+  return isVisible(style, BoxPart::TOP) || isVisible(style, BoxPart::LEFT) ||
+         isVisible(style, BoxPart::BOTTOM) ||
+         isVisible(style, BoxPart::RIGHT) ||
+         isVisible(style, BoxPart::BACKGROUND);
+}
+
 struct Box;
 
 namespace style {
@@ -48,6 +48,56 @@ buttonBase(Target target,
   return action == MouseAction::ACTION;
 }
 
+/// The element style of a button state, for the static buttonBase()
+template<class SOURCE, bool PUSHED, bool GRABBING>
+struct ButtonStateStyle
+{
+  static constexpr ElementStyle get()
+  {
+    ButtonStyle style = SOURCE::get();
+    return {style.padding,
+            style.border,
+            style.font,
+            style.scale,
+            decideButtonColors(style, PUSHED, GRABBING)};
+  }
+};
+
+/// @copydoc buttonBase()
+/// Each of the four paint states is a StaticStyle, so their invisible parts
+/// are left out at compile time.
+template<class SOURCE>
+inline bool
+buttonBase(Target target,
+           std::string_view id,
+           std::string_view str,
+           bool pushed,
+           const SDL_Point& p,
+           StaticStyle<SOURCE>)
+{
+  constexpr ButtonStyle style = SOURCE::get();
+  if (str.empty()) {
+    str = id;
+  }
+  auto adv = elementSize(style.padding + style.border,
+                         measure(str, style.font, style.scale));
+  SDL_Rect r{p.x, p.y, adv.x, adv.y};
+  auto action = target.checkMouse(id, r);
+  using Normal = StaticStyle<ButtonStateStyle<SOURCE, false, false>>;
+  using Grabbed = StaticStyle<ButtonStateStyle<SOURCE, false, true>>;
+  using Pressed = StaticStyle<ButtonStateStyle<SOURCE, true, false>>;
+  using PressedGrabbed = StaticStyle<ButtonStateStyle<SOURCE, true, true>>;
+  bool grabbing = action == MouseAction::HOLD;
+  if (pushed) {
+    grabbing ? element(target, str, r, PressedGrabbed{})
+             : element(target, str, r, Pressed{});
+  } else {
+    grabbing ? element(target, str, r, Grabbed{})
+             : element(target, str, r, Normal{});
+  }
+  return action == MouseAction::ACTION;
+}
+
 /**
  * @brief A push button
  * @ingroup elements
@@ -74,6 +124,29 @@ button(Target target,
 }
 /// @copydoc button()
 /// @ingroup elements
+template<class SOURCE>
+inline bool
+button(Target target,
+       std::string_view id,
+       std::string_view str,
+       const SDL_Point& p,
+       StaticStyle<SOURCE> style)
+{
+  return buttonBase(target, id, str, false, p, style);
+}
+/// @copydoc button()
+/// @ingroup elements
+template<class SOURCE>
+inline bool
+button(Target target,
+       std::string_view id,
+       std::string_view str,
+       StaticStyle<SOURCE> style)
+{
+  return button(target, id, str, {0}, style);
+}
+/// @copydoc button()
+/// @ingroup elements
 inline bool
 button(Target target,
        std::string_view id,
@@ -82,6 +155,25 @@ button(Target target,
 {
   return button(target, id, id, p, style);
 }
+/// @copydoc button()
+/// @ingroup elements
+template<class SOURCE>
+inline bool
+button(Target target,
+       std::string_view id,
+       const SDL_Point& p,
+       StaticStyle<SOURCE> style)
+{
+  return button(target, id, id, p, style);
+}
+/// @copydoc button()
+/// @ingroup elements
+template<class SOURCE>
+inline bool
+button(Target target, std::string_view id, StaticStyle<SOURCE> style)
+{
+  return button(target, id, id, {0}, style);
+}
 
 /**
  * @brief A button that toggle a boolean variable
@@ -0,0 +1,153 @@
+#ifndef DUI_COMBOBOX_HPP_
+#define DUI_COMBOBOX_HPP_
+
+#ifndef DUI_BOUNDED_MEMORY
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <SDL.h>
+#include "ComboBoxStyle.hpp"
+#include "Element.hpp"
+#include "Group.hpp"
+#include "InputBox.hpp"
+#include "Layer.hpp"
+#include "OptionIndex.hpp"
+#include "Scrollable.hpp"
+
+namespace dui {
+
+/// The state of a comboBox() between frames
+struct ComboBoxState
+{
+  std::string query;            ///< Text typed to search the options
+  SDL_Point scrollOffset{0, 0}; ///< Scroll of the options list
+  bool open = false;            ///< If the options list is shown
+};
+
+/**
+ * @brief A box to choose one of many options, searching them by typing
+ * @ingroup elements
+ *
+ * Clicking on it opens a list of options on a layer() below it. Typing shows
+ * only the options containing the typed text, and Enter chooses the first.
+ * Only the visible rows of the list are built, so it is fine with hundreds
+ * of thousands of options. Escape or clicking outside closes the list.
+ *
+ * @param target the parent group or frame
+ * @param id the combo box id
+ * @param value the index of the chosen option, on options
+ * @param options the options, it can be shared by many combo boxes
+ * @param combo the combo box state, it must be kept between frames
+ * @param r the relative position and size. If size is 0, the size of an
+ * input box is used
+ * @param style
+ * @return true if an option was chosen on this frame
+ */
+inline bool
+comboBox(Target target,
+         std::string_view id,
+         int* value,
+         OptionIndex* options,
+         ComboBoxState* combo,
+         const SDL_Rect& r = {0},
+         const ComboBoxStyle& style = themeFor<ComboBox>())
+{
+  SDL_assert(value != nullptr && options != nullptr && combo != nullptr);
+  auto& names = options->getOptions();
+  auto rect = makeInputRect(r, style.box);
+  auto g = group(target, id, rect, Layout::NONE);
+  Target client = g;
+  SDL_Rect boxRect{0, 0, rect.w, rect.h};
+
+  std::string_view shown{combo->query};
+  if (!combo->open && *value >= 0 && size_t(*value) < names.size()) {
+    shown = names[*value];
+  }
+  auto action = client.checkMouse("search", boxRect);
+  auto change = textBoxBase(client, "search", shown, boxRect, style.box);
+  int chosen = -1;
+  bool close = false;
+  if (!combo->open) {
+    if (action == MouseAction::GRAB) {
+      combo->open = true;
+      combo->query.clear();
+      combo->scrollOffset = {0, 0};
+    }
+  } else if (change.erase != 0 || !change.insert.empty()) {
+    combo->query.replace(change.index, change.erase, change.insert);
+    combo->scrollOffset = {0, 0};
+  } else if (client.checkText("search") == TextAction::KEYDOWN) {
+    auto key = client.lastKeyDown().sym;
+    if (key == SDLK_ESCAPE) {
+      close = true;
+    } else if (key == SDLK_RETURN || key == SDLK_KP_ENTER) {
+      auto& matches = options->find(combo->query);
+      if (!matches.empty()) {
+        chosen = matches.front();
+      }
+      close = true;
+    }
+  }
+
+  if (combo->open && !close) {
+    auto& matches = options->find(combo->query);
+    auto& option = style.option;
+    int rowH = elementSize(option.padding + option.border,
+                           measure('X', option.font, option.scale))
+                 .y;
+    int count = int(matches.size());
+    int listH = std::clamp(count, 1, style.rows) * rowH;
+    auto caret = client.getCaret();
+    auto l = layer(g, "popup", {caret.x, caret.y + rect.h, rect.w, listH});
+    auto& scrollOffset = combo->scrollOffset;
+    if (auto s = scrollable(
+          l, "list", &scrollOffset, {0, 0, rect.w, listH}, style.list)) {
+      int rowW = Target(s).width();
+      auto rows = group(s, {}, {0, 0, rowW, count * rowH}, Layout::NONE);
+      int first = std::clamp(scrollOffset.y / rowH, 0, count);
+      int last = std::clamp((scrollOffset.y + listH) / rowH + 1, 0, count);
+      for (int i = first; i < last; ++i) {
+        int index = matches[i];
+        auto& name = names[index];
+        SDL_Rect rowRect{0, i * rowH, rowW, rowH};
+        // Names can repeat, so the option index is the id
+        char id[16];
+        SDL_itoa(index, id, 10);
+        if (Target(rows).checkMouse(id, rowRect) == MouseAction::ACTION) {
+          chosen = index;
+          close = true;
+        }
+        element(
+          rows, name, rowRect, index == *value ? style.selected : option);
+      }
+    }
+    box(l, {0, 0, rect.w, listH}, style.popup);
+
+    // Anything else clicked while open just closes it. It waits the release,
+    // as a grabbed element must not disappear
+    Target popup = l;
+    auto& state = popup.getState();
+    auto topLeft = popup.getCaret();
+    SDL_Rect screen{
+      -topLeft.x, -topLeft.y, state.getWidth(), state.getHeight()};
+    auto outside = popup.checkMouse("outside", screen);
+    if (outside == MouseAction::ACTION || outside == MouseAction::CANCEL) {
+      close = true;
+    }
+  }
+  if (close) {
+    combo->open = false;
+  }
+  if (chosen >= 0 && chosen != *value) {
+    *value = chosen;
+    return true;
+  }
+  return false;
+}
+
+} // namespace dui
+
+#endif // DUI_BOUNDED_MEMORY
+
+#endif // DUI_COMBOBOX_HPP_
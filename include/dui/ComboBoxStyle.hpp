@@ -0,0 +1,74 @@
+#ifndef DUI_COMBOBOXSTYLE_HPP_
+#define DUI_COMBOBOXSTYLE_HPP_
+
+#include "BoxStyle.hpp"
+#include "ButtonStyle.hpp"
+#include "ElementStyle.hpp"
+#include "InputBoxStyle.hpp"
+#include "ScrollableStyle.hpp"
+#include "Theme.hpp"
+
+namespace dui {
+
+// Style for combo box
+struct ComboBoxStyle
+{
+  InputBoxStyle box;
+  BoxStyle popup;
+  ScrollableStyle list;
+  ElementStyle option;
+  ElementStyle selected;
+  int rows; ///< Max number of options shown at once
+
+  constexpr ComboBoxStyle withBox(const InputBoxStyle& box) const
+  {
+    return {box, popup, list, option, selected, rows};
+  }
+  constexpr ComboBoxStyle withPopup(const BoxStyle& popup) const
+  {
+    return {box, popup, list, option, selected, rows};
+  }
+  constexpr ComboBoxStyle withList(const ScrollableStyle& list) const
+  {
+    return {box, popup, list, option, selected, rows};
+  }
+  constexpr ComboBoxStyle withOption(const ElementStyle& option) const
+  {
+    return {box, popup, list, option, selected, rows};
+  }
+  constexpr ComboBoxStyle withSelected(const ElementStyle& selected) const
+  {
+    return {box, popup, list, option, selected, rows};
+  }
+  constexpr ComboBoxStyle withRows(int rows) const
+  {
+    return {box, popup, list, option, selected, rows};
+  }
+};
+
+struct ComboBox;
+
+namespace style {
+
+template<class Theme>
+struct FromTheme<ComboBox, Theme>
+{
+  constexpr static ComboBoxStyle get()
+  {
+    auto option = themeFor<Element, Theme>();
+    return {
+      themeFor<TextBox, Theme>(),
+      themeFor<Box, Theme>(),
+      themeFor<Scrollable, Theme>().withFixVertical(true),
+      option,
+      option.withBackgroundColor(
+        themeFor<ButtonBase, Theme>().grabbed.background),
+      8,
+    };
+  }
+};
+} // namespace style
+
+} // namespace dui
+
+#endif // DUI_COMBOBOXSTYLE_HPP_
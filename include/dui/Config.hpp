@@ -0,0 +1,70 @@
+#ifndef DUI_CONFIG_HPP_
+#define DUI_CONFIG_HPP_
+
+/**
+ * @file Config.hpp
+ * @brief Compile time configuration
+ *
+ * Define DUI_BOUNDED_MEMORY before including dui to make it run without heap
+ * allocations. The display list, the ids on State and the group initializers
+ * then use fixed capacity buffers, sized by the macros below. Anything that
+ * does not fit is dropped and counted on FrameStats, instead of growing the
+ * buffers.
+ *
+ * Notice that the buffers are inside State, so you probably want it to have
+ * static storage in this mode.
+ *
+ * Define DUI_COMPILED to use dui as a compiled library. The headers then only
+ * declare the larger non template functions and the common window and panel
+ * instantiations. A single translation unit compiles them, by defining
+ * DUI_IMPLEMENTATION too before including dui. The dui_compiled CMake target
+ * does that with src/dui.cpp.
+ */
+
+#ifdef DUI_COMPILED
+/// The linkage of the functions compiled once in DUI_COMPILED mode
+#define DUI_INLINE
+#else
+#define DUI_INLINE inline
+#endif
+
+#if !defined(DUI_COMPILED) || defined(DUI_IMPLEMENTATION)
+/// Defined when the DUI_INLINE functions are defined by this translation unit
+#define DUI_DEFINITIONS
+#endif
+
+#ifdef DUI_BOUNDED_MEMORY
+
+/// Max number of commands per layer on the display list
+#ifndef DUI_MAX_COMMANDS
+#define DUI_MAX_COMMANDS 2048
+#endif
+
+/// Max number of polyline points per layer on the display list
+#ifndef DUI_MAX_POINTS
+#define DUI_MAX_POINTS 4096
+#endif
+
+/// Max number of triangle vertices per layer on the display list
+#ifndef DUI_MAX_VERTICES
+#define DUI_MAX_VERTICES 8192
+#endif
+
+/// Max bytes of the texts made by State.format() on a frame
+#ifndef DUI_MAX_FRAME_TEXT
+#define DUI_MAX_FRAME_TEXT 4096
+#endif
+
+/// Max size of qualified ids, including all its group names
+#ifndef DUI_MAX_ID_SIZE
+#define DUI_MAX_ID_SIZE 256
+#endif
+
+/// Max size in bytes of the client initializer captured by panels and windows
+#ifndef DUI_MAX_INITIALIZER_SIZE
+#define DUI_MAX_INITIALIZER_SIZE 256
+#endif
+
+#endif // DUI_BOUNDED_MEMORY
+
+#endif // DUI_CONFIG_HPP_
@@ -1,9 +1,16 @@
 #ifndef DUI_DISPLAY_LIST_HPP
 #define DUI_DISPLAY_LIST_HPP
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <SDL_rect.h>
 #include <SDL_render.h>
+#include <SDL_version.h>
+#include "Config.hpp"
+#include "FixedVector.hpp"
+#include "FrameStats.hpp"
+#include "MemoryStats.hpp"
 
 namespace dui {
 
@@ -41,6 +48,20 @@ struct Shape
   }
 };
 
+/// A triangle corner, with its own color so edges can fade out
+struct Vertex
+{
+  float x;
+  float y;
+  SDL_Color color;
+};
+
+#ifdef DUI_BOUNDED_MEMORY
+using VertexBuffer = FixedVector<Vertex, DUI_MAX_VERTICES>;
+#else
+using VertexBuffer = std::vector<Vertex>;
+#endif
+
 /**
  * @brief Contains the list of elements to render
  *
@@ -52,6 +73,36 @@ class DisplayList
     POP_CLIP,
     PUSH_CLIP,
     SHAPE,
+    POP_LATCH,
+    PUSH_LATCH,
+    POLYLINE,
+    GEOMETRY,
+  };
+
+  // Shapes that follow the mouse, rect is their bounds
+  struct Latch
+  {
+    SDL_Rect rect;
+    SDL_Rect bounds;
+    SDL_Point steps;
+    SDL_Point residual;
+  };
+
+  // Connected line segments, its points are on the layer points
+  struct Polyline
+  {
+    SDL_Rect bounds;
+    Uint32 first;
+    Uint32 count;
+    SDL_Color color;
+  };
+
+  // Triangles, its vertices are on the layer vertices
+  struct Geometry
+  {
+    SDL_Rect bounds;
+    Uint32 first;
+    Uint32 count;
   };
 
   struct Command
@@ -60,11 +111,14 @@ class DisplayList
     {
       Shape shape;
       SDL_Rect rect;
+      Latch latch;
+      Polyline polyline;
+      Geometry geometry;
     };
     CommandType type;
 
-    Command()
-      : type(POP_CLIP)
+    Command(CommandType type = POP_CLIP)
+      : type(type)
     {}
     Command(const Shape& shape)
       : shape(shape)
@@ -74,105 +128,1037 @@ class DisplayList
       : rect(rect)
       , type(PUSH_CLIP)
     {}
+    Command(const Latch& latch)
+      : latch(latch)
+      , type(PUSH_LATCH)
+    {}
+    Command(const Polyline& polyline)
+      : polyline(polyline)
+      , type(POLYLINE)
+    {}
+    Command(const Geometry& geometry)
+      : geometry(geometry)
+      , type(GEOMETRY)
+    {}
   };
   static constexpr int MAX_LAYERS = 8;
-  std::vector<Command> items[MAX_LAYERS];
+  static constexpr int MAX_CLIPS = 32; // TODO make this configurable
+  static constexpr int MAX_TILES = 4096;
+  static constexpr int TRIM_WINDOW = 256;     // Frames between trims
+  static constexpr size_t MIN_CAPACITY = 256; // Commands per layer
+#ifdef DUI_BOUNDED_MEMORY
+  using CommandList = FixedVector<Command, DUI_MAX_COMMANDS>;
+  using PointList = FixedVector<SDL_Point, DUI_MAX_POINTS>;
+  using VertexList = FixedVector<Vertex, DUI_MAX_VERTICES>;
+#else
+  using CommandList = std::vector<Command>;
+  using PointList = std::vector<SDL_Point>;
+  using VertexList = std::vector<Vertex>;
+#endif
+  CommandList items[MAX_LAYERS];
+  PointList points[MAX_LAYERS];
+  VertexList vertices[MAX_LAYERS];
   int zIndex = 0;
   int maxZIndex = 0;
 
+  // Clips (and latches) begun but not ended and the ones dropped for lack of
+  // space
+  int openClips[MAX_LAYERS] = {0};
+  int droppedClips[MAX_LAYERS] = {0};
+  int droppedLayers = 0; // Layers begun over the top one
+  int dropped = 0;
+
+  // Peak sizes for the current and the previous window, per layer
+  size_t peaks[MAX_LAYERS] = {0};
+  size_t lastPeaks[MAX_LAYERS] = {0};
+  size_t pointPeaks[MAX_LAYERS] = {0};
+  size_t lastPointPeaks[MAX_LAYERS] = {0};
+  size_t vertexPeaks[MAX_LAYERS] = {0};
+  size_t lastVertexPeaks[MAX_LAYERS] = {0};
+  int frameCount = 0;
+
+  // Scratch buffers for cull(), kept to avoid allocating every frame
+#ifdef DUI_BOUNDED_MEMORY
+  FixedVector<SDL_Rect, MAX_LAYERS * DUI_MAX_COMMANDS> visibleRects;
+  FixedVector<Uint8, MAX_TILES> coveredTiles;
+#else
+  std::vector<SDL_Rect> visibleRects;
+  std::vector<Uint8> coveredTiles;
+#endif
+
+  void trim();
+
+  // Check if count commands fit on current layer, keeping space to end the
+  // open clips. Inside a dropped clip or layer nothing fits, as it would be
+  // unclipped or drawn under what it should cover
+  bool hasRoom(size_t count) const
+  {
+    auto& layer = items[zIndex];
+    return droppedClips[zIndex] == 0 && droppedLayers == 0 &&
+           layer.size() + openClips[zIndex] + count <= layer.max_size();
+  }
+
+  // Check if a clip or latch can begin, which also needs room on the stacks
+  // render() and cull() keep for them
+  bool hasClipRoom() const
+  {
+    return openClips[zIndex] < MAX_CLIPS && hasRoom(2);
+  }
+
+  // Latch offset on an axis moved in steps across span, like a quantized
+  // value would be on the next frame
+  static int snapLatch(int motion, int residual, int steps, int span)
+  {
+    if (steps <= 0 || span <= 0) {
+      return motion;
+    }
+    return (motion + residual) * steps / span * span / steps;
+  }
+
 public:
+  DisplayList() = default;
+
+  /// Ctor for a list that starts adding commands on the given layer
+  explicit DisplayList(int zIndex)
+    : zIndex(zIndex)
+    , maxZIndex(zIndex)
+  {}
+
+#ifndef DUI_BOUNDED_MEMORY
+  /**
+   * @brief An empty list to be added back with append()
+   *
+   * It starts on the current layer and counts the clips open on this, as its
+   * commands are added inside them.
+   */
+  DisplayList fork() const
+  {
+    DisplayList other{zIndex};
+    other.openClips[zIndex] = openClips[zIndex];
+    other.droppedClips[zIndex] = droppedClips[zIndex];
+    other.droppedLayers = droppedLayers;
+    return other;
+  }
+#endif
+
   void clear()
   {
     for (int i = 0; i <= maxZIndex; ++i) {
       items[i].clear();
+      points[i].clear();
+      vertices[i].clear();
+      openClips[i] = droppedClips[i] = 0;
     }
     maxZIndex = 0;
+    droppedLayers = 0;
+    dropped = 0;
+    if (++frameCount >= TRIM_WINDOW) {
+      frameCount = 0;
+      trim();
+    }
   }
 
+  /**
+   * @brief Record the current size of each layer
+   *
+   * This must be called once a frame, after all commands were added, and
+   * before they are removed by cull() or optimize(). The peak sizes over the
+   * last frames are used to release memory after usage spikes.
+   */
+  void updateUsage()
+  {
+    for (int i = 0; i <= maxZIndex; ++i) {
+      peaks[i] = std::max(peaks[i], items[i].size());
+      pointPeaks[i] = std::max(pointPeaks[i], points[i].size());
+      vertexPeaks[i] = std::max(vertexPeaks[i], vertices[i].size());
+    }
+  }
+
+  /// Get the memory used by the list
+  MemoryStats getMemoryStats() const;
+
   void insert(const Shape& item)
   {
-    if (item.color.a > 0) {
-      items[zIndex].push_back({item});
+    if (item.color.a == 0) {
+      return;
     }
+    if (!hasRoom(1)) {
+      dropped++;
+      return;
+    }
+    items[zIndex].push_back({item});
   }
 
+  /**
+   * @brief Add connected line segments
+   *
+   * All of them are drawn with a single call, so this is much cheaper than a
+   * box for each segment.
+   *
+   * @param p the points, at least 2
+   * @param count the number of points
+   * @param c the color
+   * @param offset added to each point
+   */
+  void insertPolyline(const SDL_Point* p,
+                      size_t count,
+                      SDL_Color c,
+                      const SDL_Point& offset = {0, 0});
+
+  /**
+   * @brief Add triangles
+   *
+   * Consecutive triangles under the same clip are drawn with a single call.
+   * This needs SDL 2.0.18 or newer, on older ones only the triangles with no
+   * transparent corner are filled, with the color of their first vertex.
+   *
+   * @param v the vertices, 3 for each triangle
+   * @param count the number of vertices
+   * @param offset added to each vertex
+   */
+  void insertGeometry(const Vertex* v,
+                      size_t count,
+                      const SDL_Point& offset = {0, 0});
+
   void pushClip(const SDL_Rect& rect)
   {
+    if (droppedClips[zIndex] > 0) {
+      droppedClips[zIndex]--;
+      dropped++;
+      return;
+    }
+    openClips[zIndex]--;
     // TODO coalesce multiple clips
     if (rect.w > 0 && rect.h > 0) {
       items[zIndex].push_back({rect});
     } else {
-      items[zIndex].push_back({{rect.x, rect.y, 1, 1}});
+      items[zIndex].push_back(SDL_Rect{rect.x, rect.y, 1, 1});
+    }
+  }
+
+  void popClip()
+  {
+    // Once a clip is dropped, all its inner ones must be dropped too
+    if (!hasClipRoom()) {
+      droppedClips[zIndex]++;
+      dropped++;
+      return;
     }
+    openClips[zIndex]++;
+    items[zIndex].push_back({});
   }
 
-  void popClip() { items[zIndex].push_back({}); }
+  /**
+   * @brief Begin shapes that are being dragged by the mouse
+   *
+   * The shapes added until pushLatch() are moved at render by the mouse
+   * movement since the list was built. Like clips, it is ended by a push as
+   * commands are rendered in reverse. Latches can not nest.
+   */
+  void popLatch()
+  {
+    if (!hasClipRoom()) {
+      droppedClips[zIndex]++;
+      dropped++;
+      return;
+    }
+    openClips[zIndex]++;
+    items[zIndex].push_back({POP_LATCH});
+  }
+
+  /**
+   * @brief End the shapes begun by popLatch()
+   *
+   * @param rect the global rect of the shapes
+   * @param bounds where the rect can be moved to. To move only horizontally,
+   * make its y and h the same of rect, and vice-versa.
+   * @param steps in how many steps the rect moves across the free space in
+   * bounds on each axis, or 0 to move freely
+   * @param residual the motion already made but not yet applied to rect,
+   * counted when snapping to the steps
+   */
+  void pushLatch(const SDL_Rect& rect,
+                 const SDL_Rect& bounds,
+                 SDL_Point steps = {0, 0},
+                 SDL_Point residual = {0, 0})
+  {
+    if (droppedClips[zIndex] > 0) {
+      droppedClips[zIndex]--;
+      dropped++;
+      return;
+    }
+    openClips[zIndex]--;
+    items[zIndex].push_back(Latch{rect, bounds, steps, residual});
+  }
+
+  /**
+   * @brief Number of commands dropped on this frame
+   *
+   * This happens when DUI_BOUNDED_MEMORY is defined and a layer is full, or
+   * when clips nest deeper than MAX_CLIPS or layers more than MAX_LAYERS.
+   */
+  int getDropped() const { return dropped; }
+
+  /// Commands copied from the list by record(), to be added back by replay()
+  class Recording
+  {
+    std::vector<Command> commands;
+    std::vector<SDL_Point> points;
+    std::vector<Vertex> vertices;
+    friend class DisplayList;
+  };
 
-  void render(SDL_Renderer* renderer) const;
+  /// The current position on current layer, to be passed to record()
+  size_t mark() const { return items[zIndex].size(); }
+
+  /// Copy the commands added to current layer since the given mark()
+  void record(size_t start, Recording& recording) const
+  {
+    auto& layer = items[zIndex];
+    recording.commands.assign(layer.begin() + start, layer.end());
+    recording.points.clear();
+    recording.vertices.clear();
+    for (auto& command : recording.commands) {
+      if (command.type == POLYLINE) {
+        auto& line = command.polyline;
+        auto p = points[zIndex].begin() + line.first;
+        line.first = Uint32(recording.points.size());
+        recording.points.insert(recording.points.end(), p, p + line.count);
+      } else if (command.type == GEOMETRY) {
+        auto& geometry = command.geometry;
+        auto v = vertices[zIndex].begin() + geometry.first;
+        geometry.first = Uint32(recording.vertices.size());
+        recording.vertices.insert(
+          recording.vertices.end(), v, v + geometry.count);
+      }
+    }
+  }
+
+  /// Add the recorded commands to current layer, moved by the given offset
+  void replay(const Recording& recording, const SDL_Point& offset);
+
+#ifndef DUI_BOUNDED_MEMORY
+  /**
+   * @brief Add all commands of other list after the ones on this
+   *
+   * Each layer of other goes to the end of the same layer on this. The other
+   * list must have all its clips ended.
+   */
+  void append(const DisplayList& other)
+  {
+    for (int i = 0; i <= other.maxZIndex; ++i) {
+      auto& layer = other.items[i];
+      auto start = items[i].size();
+      auto pointStart = Uint32(points[i].size());
+      auto vertexStart = Uint32(vertices[i].size());
+      items[i].insert(items[i].end(), layer.begin(), layer.end());
+      points[i].insert(
+        points[i].end(), other.points[i].begin(), other.points[i].end());
+      vertices[i].insert(vertices[i].end(),
+                         other.vertices[i].begin(),
+                         other.vertices[i].end());
+      for (auto j = start; j < items[i].size(); ++j) {
+        if (items[i][j].type == POLYLINE) {
+          items[i][j].polyline.first += pointStart;
+        } else if (items[i][j].type == GEOMETRY) {
+          items[i][j].geometry.first += vertexStart;
+        }
+      }
+    }
+    maxZIndex = std::max(maxZIndex, other.maxZIndex);
+    dropped += other.dropped;
+  }
+#endif
 
+  /**
+   * @brief Render the list
+   *
+   * @param renderer the renderer
+   * @param stats if not null, it receives the shape and call counters
+   * @param latch the mouse movement since the list was built, to be applied
+   * to the shapes between popLatch() and pushLatch()
+   */
+  void render(SDL_Renderer* renderer,
+              FrameStats* stats = nullptr,
+              const SDL_Point& latch = {0, 0}) const;
+
+  /**
+   * @brief Remove shapes that would be completely hidden when rendered
+   *
+   * A shape is hidden if it is completely clipped out or if opaque boxes drawn
+   * over it, in the same or in upper layers, cover it. The coverage is tracked
+   * in a coarse tile grid, so only tiles fully inside an opaque box count as
+   * covered.
+   *
+   * @return int the number of removed shapes
+   */
+  int cull();
+
+  /**
+   * @brief Remove useless commands from the list
+   *
+   * This removes shapes with no area and clips with nothing drawn inside them.
+   * It also merges abutting untextured shapes with the same color that are
+   * drawn one after the other into a single shape.
+   *
+   * @return int the number of removed commands
+   */
+  int optimize();
+
+  // Over the top layer, it stays there and the commands added are dropped
   void incZ()
   {
+    if (droppedLayers > 0 || zIndex + 1 >= MAX_LAYERS) {
+      droppedLayers++;
+      return;
+    }
     zIndex++;
     if (zIndex > maxZIndex) {
       maxZIndex = zIndex;
-      SDL_assert(maxZIndex < MAX_LAYERS);
     }
   }
-  void decZ() { zIndex--; }
+  void decZ()
+  {
+    if (droppedLayers > 0) {
+      droppedLayers--;
+      return;
+    }
+    zIndex--;
+  }
 
   int getZIndex() const { return zIndex; }
 
   int getMaxZIndex() const { return maxZIndex; }
 };
 
-inline void
-DisplayList::render(SDL_Renderer* renderer) const
+#ifdef DUI_DEFINITIONS
+DUI_INLINE void
+DisplayList::trim()
+{
+  // Keep capacity for the peak of the last two windows, releasing the rest if
+  // it is more than double of that. On bounded memory the capacity is fixed
+  size_t totalPeak = 0;
+  for (int i = 0; i < MAX_LAYERS; ++i) {
+    size_t peak = std::max({peaks[i], lastPeaks[i], MIN_CAPACITY});
+    totalPeak += peak;
+#ifndef DUI_BOUNDED_MEMORY
+    if (items[i].capacity() > peak * 2) {
+      // It is called just after clear(), so there is nothing to copy
+      CommandList trimmed;
+      trimmed.reserve(peak);
+      items[i].swap(trimmed);
+    }
+    size_t pointPeak = std::max(pointPeaks[i], lastPointPeaks[i]);
+    if (points[i].capacity() > pointPeak * 2) {
+      PointList trimmed;
+      trimmed.reserve(pointPeak);
+      points[i].swap(trimmed);
+    }
+    size_t vertexPeak = std::max(vertexPeaks[i], lastVertexPeaks[i]);
+    if (vertices[i].capacity() > vertexPeak * 2) {
+      VertexList trimmed;
+      trimmed.reserve(vertexPeak);
+      vertices[i].swap(trimmed);
+    }
+#endif
+    lastPeaks[i] = peaks[i];
+    peaks[i] = 0;
+    lastPointPeaks[i] = pointPeaks[i];
+    pointPeaks[i] = 0;
+    lastVertexPeaks[i] = vertexPeaks[i];
+    vertexPeaks[i] = 0;
+  }
+#ifndef DUI_BOUNDED_MEMORY
+  if (visibleRects.capacity() > totalPeak * 2) {
+    std::vector<SDL_Rect>().swap(visibleRects);
+  }
+#endif
+}
+
+DUI_INLINE void
+DisplayList::replay(const Recording& recording, const SDL_Point& offset)
+{
+  for (auto command : recording.commands) {
+    if (command.type == POP_CLIP) {
+      popClip();
+    } else if (command.type == PUSH_CLIP) {
+      command.rect.x += offset.x;
+      command.rect.y += offset.y;
+      pushClip(command.rect);
+    } else if (command.type == POP_LATCH) {
+      popLatch();
+    } else if (command.type == PUSH_LATCH) {
+      auto& latch = command.latch;
+      latch.rect.x += offset.x;
+      latch.rect.y += offset.y;
+      latch.bounds.x += offset.x;
+      latch.bounds.y += offset.y;
+      pushLatch(latch.rect, latch.bounds, latch.steps, latch.residual);
+    } else if (command.type == POLYLINE) {
+      auto& line = command.polyline;
+      insertPolyline(
+        &recording.points[line.first], line.count, line.color, offset);
+    } else if (command.type == GEOMETRY) {
+      auto& geometry = command.geometry;
+      insertGeometry(
+        &recording.vertices[geometry.first], geometry.count, offset);
+    } else {
+      command.shape.rect.x += offset.x;
+      command.shape.rect.y += offset.y;
+      insert(command.shape);
+    }
+  }
+}
+
+DUI_INLINE void
+DisplayList::insertPolyline(const SDL_Point* p,
+                            size_t count,
+                            SDL_Color c,
+                            const SDL_Point& offset)
+{
+  auto& layerPoints = points[zIndex];
+  if (c.a == 0 || count < 2) {
+    return;
+  }
+  if (!hasRoom(1) || layerPoints.size() + count > layerPoints.max_size()) {
+    dropped++;
+    return;
+  }
+  Polyline line{{0}, Uint32(layerPoints.size()), Uint32(count), c};
+  int x0 = p[0].x, y0 = p[0].y, x1 = p[0].x, y1 = p[0].y;
+  for (size_t i = 0; i < count; ++i) {
+    SDL_Point point{p[i].x + offset.x, p[i].y + offset.y};
+    layerPoints.push_back(point);
+    x0 = std::min(x0, p[i].x);
+    y0 = std::min(y0, p[i].y);
+    x1 = std::max(x1, p[i].x);
+    y1 = std::max(y1, p[i].y);
+  }
+  // The end points are drawn too
+  line.bounds = {x0 + offset.x, y0 + offset.y, x1 - x0 + 1, y1 - y0 + 1};
+  items[zIndex].push_back({line});
+}
+
+DUI_INLINE void
+DisplayList::insertGeometry(const Vertex* v,
+                            size_t count,
+                            const SDL_Point& offset)
+{
+  SDL_assert(count % 3 == 0);
+  auto& layerVertices = vertices[zIndex];
+  if (count < 3) {
+    return;
+  }
+  if (!hasRoom(1) || layerVertices.size() + count > layerVertices.max_size()) {
+    dropped++;
+    return;
+  }
+  Geometry geometry{{0}, Uint32(layerVertices.size()), Uint32(count)};
+  float x0 = v[0].x, y0 = v[0].y, x1 = v[0].x, y1 = v[0].y;
+  for (size_t i = 0; i < count; ++i) {
+    Vertex vertex{v[i].x + offset.x, v[i].y + offset.y, v[i].color};
+    layerVertices.push_back(vertex);
+    x0 = std::min(x0, v[i].x);
+    y0 = std::min(y0, v[i].y);
+    x1 = std::max(x1, v[i].x);
+    y1 = std::max(y1, v[i].y);
+  }
+  int left = int(std::floor(x0)) + offset.x;
+  int top = int(std::floor(y0)) + offset.y;
+  geometry.bounds = {left,
+                     top,
+                     int(std::ceil(x1)) + offset.x - left,
+                     int(std::ceil(y1)) + offset.y - top};
+  items[zIndex].push_back({geometry});
+}
+
+DUI_INLINE MemoryStats
+DisplayList::getMemoryStats() const
+{
+  MemoryStats stats{0};
+  for (int i = 0; i < MAX_LAYERS; ++i) {
+    stats.reserved += items[i].capacity() * sizeof(Command);
+    stats.used += items[i].size() * sizeof(Command);
+    stats.highWaterMark += std::max(peaks[i], lastPeaks[i]) * sizeof(Command);
+    stats.reserved += points[i].capacity() * sizeof(SDL_Point);
+    stats.used += points[i].size() * sizeof(SDL_Point);
+    stats.highWaterMark +=
+      std::max(pointPeaks[i], lastPointPeaks[i]) * sizeof(SDL_Point);
+    stats.reserved += vertices[i].capacity() * sizeof(Vertex);
+    stats.used += vertices[i].size() * sizeof(Vertex);
+    stats.highWaterMark +=
+      std::max(vertexPeaks[i], lastVertexPeaks[i]) * sizeof(Vertex);
+  }
+  stats.reserved += visibleRects.capacity() * sizeof(SDL_Rect);
+  stats.reserved += coveredTiles.capacity() * sizeof(Uint8);
+  return stats;
+}
+
+DUI_INLINE void
+DisplayList::render(SDL_Renderer* renderer,
+                    FrameStats* stats,
+                    const SDL_Point& latch) const
 {
+  // We shadow the renderer state, so SDL is only called on actual changes.
+  // The naiveCalls is what we would call if every change were applied
+  int calls = 0;
+  int naiveCalls = 3; // get, set and restore the blend mode
+  int shapes = 0;
+  SDL_Color drawColor{0};
+  bool drawColorSet = false;
+  SDL_Texture* modTexture = nullptr;
+  SDL_Color modColor{0};
+  SDL_Rect clip{0};
+  bool clipEnabled = false;
+  bool clipKnown = false;
+
+  // Consecutive boxes with the same color and clip are filled by one call
+  constexpr int MAX_BATCH = 64;
+  SDL_Rect batch[MAX_BATCH];
+  int batchSize = 0;
+
+  // And so are consecutive triangles with the same clip
+  int geometrySize = 0;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  constexpr int MAX_VERTICES = 3 * 512;
+  SDL_Vertex geometryBatch[MAX_VERTICES];
+#endif
+  auto flush = [&] {
+    if (batchSize > 0) {
+      SDL_RenderFillRects(renderer, batch, batchSize);
+      calls++;
+      batchSize = 0;
+    }
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (geometrySize > 0) {
+      SDL_RenderGeometry(
+        renderer, nullptr, geometryBatch, geometrySize, nullptr, 0);
+      calls++;
+      geometrySize = 0;
+    }
+#endif
+  };
+
   // Save render state
   SDL_BlendMode blendMode;
   SDL_GetRenderDrawBlendMode(renderer, &blendMode);
-  SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+  calls++;
+  if (blendMode != SDL_BLENDMODE_BLEND) {
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    calls++;
+  }
+
+  // Offset of latched shapes, if any
+  SDL_Point offset{0, 0};
 
   // Stack
-  constexpr int STACK_MAX_SIZE = 32;
-  SDL_Rect stack[STACK_MAX_SIZE]; // TODO make this configurable
+  SDL_Rect stack[MAX_CLIPS];
   for (int zIndex = 0; zIndex <= maxZIndex; ++zIndex) {
     int stackSz = 0;
     for (auto it = items[zIndex].rbegin(); it != items[zIndex].rend(); it++) {
+      if (it->type == PUSH_LATCH) {
+        // Move with the mouse, but keep inside bounds
+        auto& r = it->latch.rect;
+        auto& b = it->latch.bounds;
+        auto& steps = it->latch.steps;
+        auto& residual = it->latch.residual;
+        offset.x = snapLatch(latch.x, residual.x, steps.x, b.w - r.w);
+        offset.x = std::min(offset.x, b.x + b.w - r.x - r.w);
+        offset.x = std::max(offset.x, b.x - r.x);
+        offset.y = snapLatch(latch.y, residual.y, steps.y, b.h - r.h);
+        offset.y = std::min(offset.y, b.y + b.h - r.y - r.h);
+        offset.y = std::max(offset.y, b.y - r.y);
+        continue;
+      }
+      if (it->type == POP_LATCH) {
+        offset = {0, 0};
+        continue;
+      }
       if (it->type == POP_CLIP) {
         SDL_assert(stackSz > 0);
         --stackSz;
-        SDL_RenderSetClipRect(renderer,
-                              stackSz > 0 ? &stack[stackSz - 1] : nullptr);
+        naiveCalls++;
         continue;
       }
       if (it->type == PUSH_CLIP) {
-        SDL_assert(stackSz < STACK_MAX_SIZE);
+        SDL_assert(stackSz < MAX_CLIPS);
         SDL_Rect rect = it->rect;
         if (stackSz > 0) {
           SDL_IntersectRect(&it->rect, &stack[stackSz - 1], &rect);
         }
         stack[stackSz++] = rect;
-        SDL_RenderSetClipRect(renderer, &rect);
+        naiveCalls++;
         continue;
       }
-      auto& shape = it->shape;
+
+      // Clip is only applied when something is drawn with it
+      if (stackSz > 0) {
+        auto& wanted = stack[stackSz - 1];
+        if (!clipKnown || !clipEnabled || !SDL_RectEquals(&clip, &wanted)) {
+          flush();
+          SDL_RenderSetClipRect(renderer, &wanted);
+          calls++;
+          clip = wanted;
+          clipEnabled = clipKnown = true;
+        }
+      } else if (!clipKnown || clipEnabled) {
+        flush();
+        SDL_RenderSetClipRect(renderer, nullptr);
+        calls++;
+        clipEnabled = false;
+        clipKnown = true;
+      }
+
+      if (it->type == POLYLINE) {
+        auto& line = it->polyline;
+        auto c = line.color;
+        shapes++;
+        naiveCalls += 2;
+        flush();
+        if (!drawColorSet || drawColor.r != c.r || drawColor.g != c.g ||
+            drawColor.b != c.b || drawColor.a != c.a) {
+          SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+          calls++;
+          drawColor = c;
+          drawColorSet = true;
+        }
+        auto p = &points[zIndex][line.first];
+        if (offset.x == 0 && offset.y == 0) {
+          SDL_RenderDrawLines(renderer, p, int(line.count));
+          calls++;
+          continue;
+        }
+        // Moved in chunks, each one starting where the last ended
+        constexpr Uint32 CHUNK = 64;
+        SDL_Point moved[CHUNK];
+        for (Uint32 i = 0; i + 1 < line.count; i += CHUNK - 1) {
+          Uint32 n = std::min(line.count - i, CHUNK);
+          for (Uint32 j = 0; j < n; ++j) {
+            moved[j] = {p[i + j].x + offset.x, p[i + j].y + offset.y};
+          }
+          SDL_RenderDrawLines(renderer, moved, int(n));
+          calls++;
+        }
+        continue;
+      }
+      if (it->type == GEOMETRY) {
+        auto& geometry = it->geometry;
+        auto v = &vertices[zIndex][geometry.first];
+        shapes++;
+        naiveCalls++;
+        if (batchSize > 0) {
+          flush();
+        }
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+        for (Uint32 i = 0; i < geometry.count; ++i) {
+          if (geometrySize == MAX_VERTICES) {
+            flush();
+          }
+          auto& vertex = geometryBatch[geometrySize++];
+          vertex.position = {v[i].x + offset.x, v[i].y + offset.y};
+          vertex.color = v[i].color;
+          vertex.tex_coord = {0, 0};
+        }
+#else
+        // Fill each triangle with spans, skipping the fading edges
+        for (Uint32 i = 0; i < geometry.count; i += 3) {
+          const Vertex* t[3] = {&v[i], &v[i + 1], &v[i + 2]};
+          auto c = t[0]->color;
+          if (t[0]->color.a == 0 || t[1]->color.a == 0 || t[2]->color.a == 0) {
+            continue;
+          }
+          if (!drawColorSet || drawColor.r != c.r || drawColor.g != c.g ||
+              drawColor.b != c.b || drawColor.a != c.a) {
+            flush();
+            SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+            calls++;
+            drawColor = c;
+            drawColorSet = true;
+          }
+          std::sort(t, t + 3, [](auto a, auto b) { return a->y < b->y; });
+          auto edgeX = [](const Vertex* a, const Vertex* b, float y) {
+            if (b->y == a->y) {
+              return a->x;
+            }
+            return a->x + (b->x - a->x) * (y - a->y) / (b->y - a->y);
+          };
+          int yEnd = int(std::ceil(t[2]->y - 0.5f));
+          for (int y = int(std::ceil(t[0]->y - 0.5f)); y < yEnd; ++y) {
+            float center = y + 0.5f;
+            float xa = edgeX(t[0], t[2], center);
+            float xb = center < t[1]->y ? edgeX(t[0], t[1], center)
+                                        : edgeX(t[1], t[2], center);
+            int x0 = int(std::ceil(std::min(xa, xb) - 0.5f));
+            int x1 = int(std::ceil(std::max(xa, xb) - 0.5f));
+            if (x1 > x0) {
+              batch[batchSize++] = {x0 + offset.x, y + offset.y, x1 - x0, 1};
+              if (batchSize == MAX_BATCH) {
+                flush();
+              }
+            }
+          }
+        }
+#endif
+        continue;
+      }
+      auto shape = it->shape;
+      shape.rect.x += offset.x;
+      shape.rect.y += offset.y;
       auto c = shape.color;
+      shapes++;
       if (shape.texture == nullptr) {
-        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
-        SDL_RenderFillRect(renderer, &shape.rect);
+        naiveCalls += 4;
+        if (geometrySize > 0) {
+          flush();
+        }
+        if (!drawColorSet || drawColor.r != c.r || drawColor.g != c.g ||
+            drawColor.b != c.b || drawColor.a != c.a) {
+          flush();
+          SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+          calls++;
+          drawColor = c;
+          drawColorSet = true;
+        }
+        batch[batchSize++] = shape.rect;
+        if (batchSize == MAX_BATCH) {
+          flush();
+        }
+        continue;
+      }
+      naiveCalls += 2;
+      flush();
+      if (modTexture != shape.texture || modColor.r != c.r ||
+          modColor.g != c.g || modColor.b != c.b) {
+        SDL_SetTextureColorMod(shape.texture, c.r, c.g, c.b);
+        calls++;
+        modTexture = shape.texture;
+        modColor = c;
       }
-      SDL_SetTextureColorMod(shape.texture, c.r, c.g, c.b);
       if (shape.srcRect.w) {
         SDL_RenderCopy(renderer, shape.texture, &shape.srcRect, &shape.rect);
       } else {
         SDL_RenderCopy(renderer, shape.texture, nullptr, &shape.rect);
       }
+      calls++;
     }
+    flush();
     SDL_assert(stackSz == 0);
   }
-  SDL_SetRenderDrawBlendMode(renderer, blendMode);
+  if (clipKnown && clipEnabled) {
+    SDL_RenderSetClipRect(renderer, nullptr);
+    calls++;
+  }
+  if (blendMode != SDL_BLENDMODE_BLEND) {
+    SDL_SetRenderDrawBlendMode(renderer, blendMode);
+    calls++;
+  }
+  if (stats) {
+    stats->shapes = shapes;
+    stats->renderCalls = calls;
+    stats->savedCalls = naiveCalls - calls;
+  }
+}
+
+DUI_INLINE int
+DisplayList::cull()
+{
+  // Evaluate the clipped rect of each shape, in render order
+  size_t offsets[MAX_LAYERS];
+  size_t total = 0;
+  for (int zIndex = 0; zIndex <= maxZIndex; ++zIndex) {
+    offsets[zIndex] = total;
+    total += items[zIndex].size();
+  }
+  visibleRects.resize(total);
+  SDL_Rect bounds{0};
+  bool hasOccluders = false;
+  SDL_Rect stack[MAX_CLIPS];
+  for (int zIndex = 0; zIndex <= maxZIndex; ++zIndex) {
+    auto& layer = items[zIndex];
+    int stackSz = 0;
+    bool latched = false;
+    for (size_t i = layer.size(); i-- > 0;) {
+      auto& command = layer[i];
+      if (command.type == PUSH_LATCH || command.type == POP_LATCH) {
+        latched = command.type == PUSH_LATCH;
+        continue;
+      }
+      if (command.type == POP_CLIP) {
+        SDL_assert(stackSz > 0);
+        --stackSz;
+        continue;
+      }
+      if (command.type == PUSH_CLIP) {
+        SDL_assert(stackSz < MAX_CLIPS);
+        SDL_Rect rect = command.rect;
+        if (stackSz > 0) {
+          SDL_IntersectRect(&command.rect, &stack[stackSz - 1], &rect);
+        }
+        stack[stackSz++] = rect;
+        continue;
+      }
+      bool isShape = command.type == SHAPE;
+      auto& shape = command.shape;
+      auto& rect = command.type == POLYLINE   ? command.polyline.bounds
+                   : command.type == GEOMETRY ? command.geometry.bounds
+                                              : shape.rect;
+      auto& visible = visibleRects[offsets[zIndex] + i];
+      visible = rect;
+      if (stackSz > 0 &&
+          !SDL_IntersectRect(&rect, &stack[stackSz - 1], &visible)) {
+        visible.w = visible.h = 0;
+      }
+      if (latched) {
+        // It might move at render, so it neither hides nor is hidden
+        visible = rect;
+        continue;
+      }
+      if (isShape && shape.texture == nullptr && shape.color.a == 255 &&
+          !SDL_RectEmpty(&visible)) {
+        if (hasOccluders) {
+          SDL_UnionRect(&bounds, &visible, &bounds);
+        } else {
+          bounds = visible;
+          hasOccluders = true;
+        }
+      }
+    }
+  }
+
+  // Tile grid over the occluders' bounds
+  int tileSize = 16;
+  int cols, rows;
+  for (;;) {
+    cols = (bounds.w + tileSize - 1) / tileSize;
+    rows = (bounds.h + tileSize - 1) / tileSize;
+    if (cols * rows <= MAX_TILES) {
+      break;
+    }
+    tileSize *= 2;
+  }
+  coveredTiles.assign(cols * rows, 0);
+
+  // Walk front to back, from the top layer down
+  int culled = 0;
+  for (int zIndex = maxZIndex; zIndex >= 0; --zIndex) {
+    auto& layer = items[zIndex];
+    size_t j = 0;
+    bool latched = false;
+    for (size_t i = 0; i < layer.size(); ++i) {
+      if (layer[i].type != SHAPE && layer[i].type != POLYLINE &&
+          layer[i].type != GEOMETRY) {
+        if (layer[i].type == POP_LATCH || layer[i].type == PUSH_LATCH) {
+          latched = layer[i].type == POP_LATCH;
+        }
+        layer[j++] = layer[i];
+        continue;
+      }
+      auto& visible = visibleRects[offsets[zIndex] + i];
+      if (SDL_RectEmpty(&visible)) {
+        culled++;
+        continue;
+      }
+      if (hasOccluders && !latched) {
+        // Tiles touched by the shape
+        int x0 = visible.x - bounds.x;
+        int y0 = visible.y - bounds.y;
+        int x1 = x0 + visible.w;
+        int y1 = y0 + visible.h;
+        bool hidden = x0 >= 0 && y0 >= 0 && x1 <= bounds.w && y1 <= bounds.h;
+        for (int y = y0 / tileSize; hidden && y <= (y1 - 1) / tileSize; ++y) {
+          for (int x = x0 / tileSize; x <= (x1 - 1) / tileSize; ++x) {
+            if (!coveredTiles[y * cols + x]) {
+              hidden = false;
+              break;
+            }
+          }
+        }
+        if (hidden) {
+          culled++;
+          continue;
+        }
+        auto& shape = layer[i].shape;
+        if (layer[i].type == SHAPE && shape.texture == nullptr &&
+            shape.color.a == 255) {
+          // Tiles fully inside the shape
+          int tx0 = (x0 + tileSize - 1) / tileSize;
+          int ty0 = (y0 + tileSize - 1) / tileSize;
+          int tx1 = x1 == bounds.w ? cols : x1 / tileSize;
+          int ty1 = y1 == bounds.h ? rows : y1 / tileSize;
+          for (int y = ty0; y < ty1; ++y) {
+            for (int x = tx0; x < tx1; ++x) {
+              coveredTiles[y * cols + x] = 1;
+            }
+          }
+        }
+      }
+      layer[j++] = layer[i];
+    }
+    layer.resize(j);
+  }
+  return culled;
+}
+
+DUI_INLINE int
+DisplayList::optimize()
+{
+  int removed = 0;
+  for (int zIndex = 0; zIndex <= maxZIndex; ++zIndex) {
+    auto& layer = items[zIndex];
+    size_t j = 0;
+    for (size_t i = 0; i < layer.size(); ++i) {
+      auto& command = layer[i];
+      if (command.type == PUSH_CLIP) {
+        // Commands are stored in reverse, so the clip begins at its POP_CLIP
+        if (j > 0 && layer[j - 1].type == POP_CLIP) {
+          j--;
+          removed += 2;
+          continue;
+        }
+      } else if (command.type == PUSH_LATCH) {
+        if (j > 0 && layer[j - 1].type == POP_LATCH) {
+          j--;
+          removed += 2;
+          continue;
+        }
+      } else if (command.type == SHAPE) {
+        auto& shape = command.shape;
+        if (shape.rect.w <= 0 || shape.rect.h <= 0) {
+          removed++;
+          continue;
+        }
+        if (j > 0 && shape.texture == nullptr && layer[j - 1].type == SHAPE) {
+          auto& last = layer[j - 1].shape;
+          auto& a = last.rect;
+          auto& b = shape.rect;
+          auto& c = shape.color;
+          if (last.texture == nullptr && last.color.r == c.r &&
+              last.color.g == c.g && last.color.b == c.b &&
+              last.color.a == c.a) {
+            if (a.y == b.y && a.h == b.h &&
+                (a.x + a.w == b.x || b.x + b.w == a.x)) {
+              a.x = std::min(a.x, b.x);
+              a.w += b.w;
+              removed++;
+              continue;
+            }
+            if (a.x == b.x && a.w == b.w &&
+                (a.y + a.h == b.y || b.y + b.h == a.y)) {
+              a.y = std::min(a.y, b.y);
+              a.h += b.h;
+              removed++;
+              continue;
+            }
+          }
+        }
+      }
+      layer[j++] = command;
+    }
+    layer.resize(j);
+  }
+  return removed;
 }
+#endif // DUI_DEFINITIONS
 
 } // namespace dui
 
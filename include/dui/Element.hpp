@@ -52,6 +52,43 @@ element(Target target,
   box(g, {0, 0, sz.x, sz.y}, style);
 }
 
+/// @copydoc element()
+/// @ingroup elements
+/// If the style has no visible box, it is left out at compile time, as well as
+/// the element group when the size is automatic.
+template<class SOURCE>
+inline void
+element(Target target,
+        std::string_view str,
+        const SDL_Rect& r,
+        StaticStyle<SOURCE> style)
+{
+  constexpr ElementStyle value = SOURCE::get();
+  constexpr auto offset = value.border + value.padding;
+  auto sz = computeSize(str, value, {r.w, r.h});
+  if constexpr (isVisible(BoxStyle(value))) {
+    auto g = group(target, {}, {r.x, r.y, sz.x, sz.y}, Layout::NONE);
+    text(g, str, {offset.left, offset.top}, value);
+    box(g, {0, 0, sz.x, sz.y}, style);
+  } else if (r.w != 0 || r.h != 0) {
+    // The group clips the text to the given size
+    auto g = group(target, {}, {r.x, r.y, sz.x, sz.y}, Layout::NONE);
+    text(g, str, {offset.left, offset.top}, value);
+  } else {
+    auto& state = target.getState();
+    SDL_assert(state.isInFrame());
+    SDL_assert(!target.isLocked());
+    auto& font = value.font.texture ? value.font : state.getFont();
+    auto caret = target.getCaret();
+    target.advance({r.x + sz.x, r.y + sz.y});
+    displayText(state,
+                str,
+                {caret.x + r.x + offset.left, caret.y + r.y + offset.top},
+                font,
+                value);
+  }
+}
+
 } // namespace dui
 
 #endif // DUI_BASIC_WIDGETS_HPP_
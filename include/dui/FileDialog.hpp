@@ -0,0 +1,468 @@
+#ifndef DUI_FILEDIALOG_HPP_
+#define DUI_FILEDIALOG_HPP_
+
+#ifndef DUI_BOUNDED_MEMORY
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Button.hpp"
+#include "Element.hpp"
+#include "InputField.hpp"
+#include "Label.hpp"
+#include "Layer.hpp"
+#include "Scrollable.hpp"
+#include "State.hpp"
+#include "Window.hpp"
+
+namespace dui {
+
+/// A directory entry, with its stat results
+struct FileEntry
+{
+  std::string name;    ///< The file name
+  std::uintmax_t size; ///< The size in bytes, 0 for directories
+  bool directory;      ///< If it is a directory
+};
+
+/**
+ * @brief The entries of a directory, as read by fileDialog()
+ *
+ * The entries are added in batches while the directory is read. When it is read
+ * again after a change, the new listing replaces the old one once complete.
+ */
+struct FileListing
+{
+  std::vector<FileEntry> entries;       ///< In the order they were read
+  std::vector<Uint32> sorted;           ///< Entry indices, directories first
+  std::filesystem::file_time_type time; ///< Directory time when read
+  bool complete = false;                ///< If all entries were read
+  Uint64 version = 0;                   ///< Unique over all, changed by sort()
+
+  /// Sort the entries added since last call, merging them with the rest
+  void sort();
+};
+
+/**
+ * @brief The state of a fileDialog()
+ *
+ * It keeps the directory listings read, so opening the dialog again on a
+ * directory that did not change shows it without reading it again.
+ */
+class FileDialogState
+{
+  using Cache =
+    std::unordered_map<std::string, std::shared_ptr<FileListing>>;
+
+  // Shared with the jobs reading directories
+  std::shared_ptr<Cache> cache = std::make_shared<Cache>();
+  std::filesystem::path directory;
+  std::filesystem::path selected;
+
+  // The directory is checked again for changes every CHECK_INTERVAL ms after
+  // the last check finished, by a job with another id
+  std::string key;
+  std::string jobId;
+  Uint32 generation = 0;
+  Uint32 checkTicks = 0;
+  bool checked = false;
+  static constexpr Uint32 CHECK_INTERVAL = 2000;
+
+  // Sorted indices that pass the filter, updated only when something changes
+  std::vector<Uint32> filtered;
+  Uint64 filteredVersion = 0;
+  std::string filteredBy;
+
+  static constexpr size_t BATCH_SIZE = 1024; // Entries per update posted
+
+  // Runs on a worker, so it touches only what it is given
+  static bool readDirectory(
+    State& state,
+    JobControl& control,
+    std::shared_ptr<Cache> cache,
+    const std::filesystem::path& directory,
+    std::shared_ptr<const FileListing> previous);
+
+public:
+  /// Text that the shown file names must contain, ignoring case
+  char filter[256] = {0};
+
+  /// Scroll offset of the list
+  SDL_Point scrollOffset{0, 0};
+
+  /// Ctor
+  explicit FileDialogState(
+    std::filesystem::path directory = std::filesystem::current_path())
+    : directory(std::move(directory))
+    , key(this->directory.string())
+  {}
+
+  /// The directory shown
+  const std::filesystem::path& getDirectory() const { return directory; }
+
+  /// Show another directory
+  void setDirectory(std::filesystem::path value)
+  {
+    directory = std::move(value);
+    key = directory.string();
+    jobId.clear();
+    scrollOffset = {0, 0};
+  }
+
+  /// Read the directory shown again
+  void refresh()
+  {
+    cache->erase(key);
+    jobId.clear();
+  }
+
+  /// The chosen file, empty if none
+  const std::filesystem::path& getSelected() const { return selected; }
+
+  /// Choose a file
+  void setSelected(std::filesystem::path value)
+  {
+    selected = std::move(value);
+  }
+
+  /**
+   * @brief The listing of the directory shown, reading it if needed
+   *
+   * It must be called every frame the directory is shown. The first time, it
+   * starts a job that reads the directory, or that just checks it did not
+   * change since it was read. Once read, it is checked again every couple of
+   * seconds, so it requests updates while shown.
+   *
+   * @param state the ui state, it must be in frame
+   * @return FileListing* the listing, with all entries read so far sorted, or
+   * nullptr if the reading did not start yet.
+   */
+  FileListing* update(State& state);
+
+  /**
+   * @brief The sorted listing indices whose names pass the filter
+   *
+   * The result is cached until the filter or the listing change.
+   */
+  const std::vector<Uint32>& visibleEntries(const FileListing& listing);
+
+  /// Forget all directory listings read
+  void clearCache() { cache->clear(); }
+};
+
+/**
+ * @brief A modal dialog to choose a file
+ * @ingroup elements
+ *
+ * The directories are read on State.getJobPool(), and their entries show up
+ * while they are read. Only the visible rows of the list are built, so
+ * directories with hundreds of thousands of files are fine.
+ *
+ * Clicking on a directory opens it, and clicking twice on a file or clicking
+ * on "Open" chooses it.
+ *
+ * @param target the parent group or frame
+ * @param id the dialog id
+ * @param dialog the dialog state, it must live while the dialog is used
+ * @param open if the dialog is shown, it is set to false when it is closed
+ * @param style
+ * @return true if a file was chosen on this frame, it is on
+ * FileDialogState.getSelected()
+ */
+inline bool
+fileDialog(Target target,
+           std::string_view id,
+           FileDialogState* dialog,
+           bool* open,
+           const WindowStyle& style = themeFor<Window>())
+{
+  SDL_assert(dialog != nullptr && open != nullptr);
+  if (!*open) {
+    return false;
+  }
+  bool chosen = false;
+  auto& state = target.getState();
+  int wW = state.getWidth();
+  int wH = state.getHeight();
+  constexpr int listW = 400;
+  constexpr int listH = 240;
+
+  auto l = layer(target, id, {0});
+  auto w =
+    window(l, "window", "Open file", {(wW - listW) / 2, wH / 8}, style);
+  auto& directory = dialog->getDirectory();
+  label(w, directory.string());
+  auto nav = group(w, {}, {0}, Layout::HORIZONTAL);
+  if (button(nav, "Up") && directory.has_relative_path()) {
+    dialog->setDirectory(directory.parent_path());
+  }
+  if (button(nav, "Refresh")) {
+    dialog->refresh();
+  }
+  nav.end();
+  textField(w, "filter", "Filter", dialog->filter, sizeof(dialog->filter));
+  auto listing = dialog->update(state);
+
+  auto rowStyle = themeFor<Label>();
+  auto selectedStyle =
+    rowStyle.withBackgroundColor(themeFor<ButtonBase>().grabbed.background);
+  int rowH = elementSize(rowStyle.padding + rowStyle.border,
+                         measure('X', rowStyle.font, rowStyle.scale))
+               .y;
+  std::optional<std::filesystem::path> opened;
+  // The rows compare names, so paths are only made when clicked
+  auto& selected = dialog->getSelected();
+  bool selectedHere = selected.parent_path() == dialog->getDirectory();
+  auto selectedName = selected.filename().string();
+  auto& scrollOffset = dialog->scrollOffset;
+  SDL_Rect listRect{0, 0, listW, listH};
+  if (auto s = scrollable(
+        w, "list", &scrollOffset, listRect, themeFor<Scrollable>())) {
+    if (listing) {
+      auto& rows = dialog->visibleEntries(*listing);
+      int count = int(rows.size());
+      int rowW = Target(s).width();
+      auto g = group(s, {}, {0, 0, rowW, count * rowH}, Layout::NONE);
+      int first = std::clamp(scrollOffset.y / rowH, 0, count);
+      int last = std::clamp((scrollOffset.y + listH) / rowH + 1, 0, count);
+      for (int i = first; i < last; ++i) {
+        auto& entry = listing->entries[rows[i]];
+        bool isSelected = selectedHere && entry.name == selectedName;
+        SDL_Rect r{0, i * rowH, rowW, rowH};
+        auto action = Target(g).checkMouse(entry.name, r);
+        if (action == MouseAction::ACTION) {
+          if (entry.directory) {
+            opened = dialog->getDirectory() / entry.name;
+          } else if (isSelected) {
+            chosen = true;
+          } else {
+            dialog->setSelected(dialog->getDirectory() / entry.name);
+          }
+        }
+        if (entry.directory) {
+          element(g, state.format("{}/", entry.name), r, rowStyle);
+          continue;
+        }
+        auto size = state.format("{}", entry.size);
+        auto sizeW = measure(size, rowStyle.font, rowStyle.scale).x;
+        label(g,
+              size,
+              {rowW - sizeW - rowStyle.padding.right, i * rowH},
+              rowStyle);
+        element(g, entry.name, r, isSelected ? selectedStyle : rowStyle);
+      }
+    }
+  }
+  if (opened) {
+    dialog->setDirectory(std::move(*opened));
+  }
+  if (!listing || !listing->complete) {
+    label(w, "Reading...");
+  }
+
+  auto buttons = group(w, {}, {0}, Layout::HORIZONTAL);
+  if (button(buttons, "Open") && !dialog->getSelected().empty()) {
+    chosen = true;
+  }
+  if (button(buttons, "Cancel")) {
+    *open = false;
+  }
+  buttons.end();
+  w.end();
+  colorBox(l, {0, 0, wW, wH}, {0, 0, 0, 127});
+  if (chosen) {
+    *open = false;
+  }
+  return chosen;
+}
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE void
+FileListing::sort()
+{
+  auto oldSize = sorted.size();
+  if (oldSize == entries.size()) {
+    return;
+  }
+  for (auto i = oldSize; i < entries.size(); ++i) {
+    sorted.push_back(Uint32(i));
+  }
+  auto less = [this](Uint32 lhs, Uint32 rhs) {
+    auto& a = entries[lhs];
+    auto& b = entries[rhs];
+    if (a.directory != b.directory) {
+      return a.directory;
+    }
+    return a.name < b.name;
+  };
+  std::sort(sorted.begin() + oldSize, sorted.end(), less);
+  std::inplace_merge(
+    sorted.begin(), sorted.begin() + oldSize, sorted.end(), less);
+  // Not just a counter per listing, as a new one can reuse a freed address
+  static std::atomic<Uint64> lastVersion{0};
+  version = ++lastVersion;
+}
+
+DUI_INLINE FileListing*
+FileDialogState::update(State& state)
+{
+  auto it = cache->find(key);
+  FileListing* listing = it != cache->end() ? it->second.get() : nullptr;
+  // Complete listings are not changed anymore, so the job can read it
+  std::shared_ptr<const FileListing> previous;
+  if (listing && listing->complete) {
+    previous = it->second;
+  }
+  // A new job id starts a new job, but not while reading
+  auto ticks = state.ticks();
+  if (jobId.empty() ||
+      (previous && checked && Sint32(ticks - checkTicks) >= 0)) {
+    jobId = key;
+    jobId += '\n';
+    jobId += std::to_string(++generation);
+  }
+  auto job = state.job(
+    jobId,
+    [&state, cache = cache, directory = directory, previous](
+      JobControl& control) {
+      return readDirectory(state, control, cache, directory, previous);
+    });
+  if (!job.isDone()) {
+    checked = false;
+  } else if (!checked) {
+    checked = true;
+    checkTicks = ticks + CHECK_INTERVAL;
+  }
+  if (checked) {
+    state.scheduleUpdate(checkTicks);
+  }
+  if (listing) {
+    listing->sort();
+  }
+  return listing;
+}
+
+DUI_INLINE bool
+FileDialogState::readDirectory(
+  State& state,
+  JobControl& control,
+  std::shared_ptr<Cache> cache,
+  const std::filesystem::path& directory,
+  std::shared_ptr<const FileListing> previous)
+{
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  auto time = fs::last_write_time(directory, ec);
+  if (previous && previous->time == time) {
+    return true;
+  }
+  auto listing = std::make_shared<FileListing>();
+  listing->time = time;
+  // The first time the entries are shown while read. When read again, the
+  // previous listing stays shown and gives the sizes of the files it had
+  std::unordered_map<std::string_view, std::uintmax_t> knownSizes;
+  if (previous) {
+    knownSizes.reserve(previous->entries.size());
+    for (auto& entry : previous->entries) {
+      if (!entry.directory) {
+        knownSizes.emplace(entry.name, entry.size);
+      }
+    }
+  } else {
+    state.post([cache, key = directory.string(), listing] {
+      (*cache)[key] = listing;
+    });
+  }
+  std::vector<FileEntry> batch;
+  auto flush = [&] {
+    state.post([listing, batch = std::move(batch)]() mutable {
+      auto& entries = listing->entries;
+      entries.insert(entries.end(),
+                     std::make_move_iterator(batch.begin()),
+                     std::make_move_iterator(batch.end()));
+    });
+    batch.clear();
+  };
+  fs::directory_iterator it{
+    directory, fs::directory_options::skip_permission_denied, ec};
+  for (; !ec && it != fs::directory_iterator{}; it.increment(ec)) {
+    if (control.isCancelled()) {
+      return false;
+    }
+    std::error_code entryEc;
+    FileEntry entry{
+      it->path().filename().string(), 0, it->is_directory(entryEc)};
+    if (!entry.directory) {
+      auto known = knownSizes.find(entry.name);
+      if (known != knownSizes.end()) {
+        entry.size = known->second;
+      } else {
+        entry.size = it->file_size(entryEc);
+        if (entryEc) {
+          entry.size = 0;
+        }
+      }
+    }
+    if (previous) {
+      listing->entries.push_back(std::move(entry));
+      continue;
+    }
+    batch.push_back(std::move(entry));
+    if (batch.size() == BATCH_SIZE) {
+      flush();
+    }
+  }
+  if (previous) {
+    // Not shown yet, so sorted here instead of on the ui thread
+    listing->sort();
+    listing->complete = true;
+    state.post([cache, key = directory.string(), listing] {
+      (*cache)[key] = listing;
+    });
+    return true;
+  }
+  flush();
+  state.post([listing] { listing->complete = true; });
+  return true;
+}
+
+DUI_INLINE const std::vector<Uint32>&
+FileDialogState::visibleEntries(const FileListing& listing)
+{
+  std::string_view wanted{filter};
+  if (wanted.empty()) {
+    return listing.sorted;
+  }
+  if (filteredVersion == listing.version && filteredBy == wanted) {
+    return filtered;
+  }
+  auto lower = [](char ch) {
+    return ch >= 'A' && ch <= 'Z' ? char(ch - 'A' + 'a') : ch;
+  };
+  auto equal = [&](char a, char b) { return lower(a) == lower(b); };
+  filtered.clear();
+  for (auto i : listing.sorted) {
+    auto& name = listing.entries[i].name;
+    if (std::search(name.begin(), name.end(), wanted.begin(), wanted.end(),
+                    equal) != name.end()) {
+      filtered.push_back(i);
+    }
+  }
+  filteredVersion = listing.version;
+  filteredBy = wanted;
+  return filtered;
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_BOUNDED_MEMORY
+
+#endif // DUI_FILEDIALOG_HPP_
@@ -0,0 +1,77 @@
+#ifndef DUI_FIXEDSTRING_HPP_
+#define DUI_FIXEDSTRING_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <SDL.h>
+
+namespace dui {
+
+/**
+ * @brief A string with fixed capacity
+ *
+ * It implements the subset of std::string used by dui. Appending past the
+ * capacity truncates the string, so the caller should check max_size() before
+ * if it matters.
+ *
+ * @tparam N the capacity
+ */
+template<size_t N>
+class FixedString
+{
+  char chars[N];
+  size_t count = 0;
+
+public:
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  constexpr size_t max_size() const { return N; }
+
+  void clear() { count = 0; }
+
+  void resize(size_t n)
+  {
+    SDL_assert(n <= count);
+    count = n;
+  }
+
+  FixedString& operator=(std::string_view str)
+  {
+    clear();
+    return *this += str;
+  }
+
+  FixedString& operator+=(char ch)
+  {
+    if (count < N) {
+      chars[count++] = ch;
+    }
+    return *this;
+  }
+
+  FixedString& operator+=(std::string_view str)
+  {
+    size_t n = std::min(str.size(), N - count);
+    SDL_memcpy(chars + count, str.data(), n);
+    count += n;
+    return *this;
+  }
+
+  char operator[](size_t i) const { return chars[i]; }
+
+  operator std::string_view() const { return {chars, count}; }
+
+  friend bool operator==(const FixedString& lhs, std::string_view rhs)
+  {
+    return std::string_view{lhs} == rhs;
+  }
+  friend bool operator!=(const FixedString& lhs, std::string_view rhs)
+  {
+    return std::string_view{lhs} != rhs;
+  }
+};
+
+} // namespace dui
+
+#endif // DUI_FIXEDSTRING_HPP_
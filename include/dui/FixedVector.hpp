@@ -0,0 +1,84 @@
+#ifndef DUI_FIXEDVECTOR_HPP_
+#define DUI_FIXEDVECTOR_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <SDL.h>
+
+namespace dui {
+
+/**
+ * @brief A vector like container with fixed capacity
+ *
+ * It implements the subset of std::vector used by dui. The caller must check
+ * max_size() before adding elements.
+ *
+ * @tparam T the element type. Must be default constructible
+ * @tparam N the capacity
+ */
+template<class T, size_t N>
+class FixedVector
+{
+  T elements[N];
+  size_t count = 0;
+
+public:
+  using iterator = T*;
+  using const_iterator = const T*;
+  using reverse_iterator = std::reverse_iterator<T*>;
+  using const_reverse_iterator = std::reverse_iterator<const T*>;
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  constexpr size_t capacity() const { return N; }
+  constexpr size_t max_size() const { return N; }
+
+  void clear() { count = 0; }
+  void reserve(size_t n) { SDL_assert(n <= N); }
+
+  void push_back(const T& value)
+  {
+    SDL_assert(count < N);
+    elements[count++] = value;
+  }
+
+  void resize(size_t n)
+  {
+    SDL_assert(n <= N);
+    for (size_t i = count; i < n; ++i) {
+      elements[i] = T{};
+    }
+    count = n;
+  }
+
+  void assign(size_t n, const T& value)
+  {
+    SDL_assert(n <= N);
+    for (size_t i = 0; i < n; ++i) {
+      elements[i] = value;
+    }
+    count = n;
+  }
+
+  T& operator[](size_t i) { return elements[i]; }
+  const T& operator[](size_t i) const { return elements[i]; }
+
+  T* begin() { return elements; }
+  const T* begin() const { return elements; }
+  T* end() { return elements + count; }
+  const T* end() const { return elements + count; }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const
+  {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const
+  {
+    return const_reverse_iterator(begin());
+  }
+};
+
+} // namespace dui
+
+#endif // DUI_FIXEDVECTOR_HPP_
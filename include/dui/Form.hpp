@@ -0,0 +1,280 @@
+#ifndef DUI_FORM_HPP_
+#define DUI_FORM_HPP_
+
+#include <algorithm>
+#include <initializer_list>
+#include <string_view>
+#include <SDL.h>
+#include "Box.hpp"
+#include "Button.hpp"
+#include "FormStyle.hpp"
+#include "Group.hpp"
+#include "Text.hpp"
+
+namespace dui {
+
+/// The kinds of FormItem
+enum class FormItemKind
+{
+  LABEL,  ///< A fixed text
+  BUTTON, ///< A push button
+  TOGGLE, ///< A toggle button, bound to a bool
+  VALUE,  ///< A fixed width box, bound to a text given each frame
+};
+
+/**
+ * @brief An item of a static form
+ *
+ * Use formLabel(), formButton(), formToggle() and formValue() to make them and
+ * layoutForm() to place them.
+ */
+struct FormItem
+{
+  FormItemKind kind = FormItemKind::LABEL;
+  std::string_view id;
+  std::string_view str;
+  int columns = 0;         ///< Width of VALUE items, in characters
+  bool beside = false;     ///< If it goes on the right of the previous item
+  SDL_Rect rect = {0};     ///< Set by layoutForm()
+  SDL_Point textPos = {0}; ///< Set by layoutForm()
+
+  /// The same item, placed on the right of the previous one
+  constexpr FormItem besidePrevious() const
+  {
+    auto item = *this;
+    item.beside = true;
+    return item;
+  }
+
+  /// True if it is bound to a FormValue
+  constexpr bool isBound() const
+  {
+    return kind == FormItemKind::TOGGLE || kind == FormItemKind::VALUE;
+  }
+};
+
+/// A fixed text on a form
+constexpr FormItem
+formLabel(std::string_view str)
+{
+  return {FormItemKind::LABEL, {}, str};
+}
+
+/// A push button on a form. If str is empty the id is shown
+constexpr FormItem
+formButton(std::string_view id, std::string_view str = {})
+{
+  return {FormItemKind::BUTTON, id, str.empty() ? id : str};
+}
+
+/// A toggle button on a form. If str is empty the id is shown
+constexpr FormItem
+formToggle(std::string_view id, std::string_view str = {})
+{
+  return {FormItemKind::TOGGLE, id, str.empty() ? id : str};
+}
+
+/// A box showing a text given each frame, cut to fit the given columns
+constexpr FormItem
+formValue(std::string_view id, int columns)
+{
+  return {FormItemKind::VALUE, id, {}, columns};
+}
+
+/// A form with all its items placed @see layoutForm()
+template<size_t N>
+struct FormLayout
+{
+  FormItem items[N];
+  SDL_Point size;
+  size_t boundCount; ///< Number of FormValue it takes
+  FormStyle style;
+};
+
+/**
+ * @brief Place the items of a static form
+ *
+ * Items are placed top to bottom, or on the right of the previous item when
+ * made with FormItem.besidePrevious(). Everything is measured with the style,
+ * so declaring the result constexpr leaves no layout work for the frames.
+ *
+ * @param items the items
+ * @param style
+ * @return FormLayout<N>
+ */
+template<size_t N>
+constexpr FormLayout<N>
+layoutForm(const FormItem (&items)[N],
+           const FormStyle& style = themeFor<Form>())
+{
+  FormLayout<N> layout{};
+  layout.style = style;
+  int rowY = 0;
+  int rowH = 0;
+  size_t rowBegin = 0;
+  int x = 0;
+  // Center the items of the row vertically
+  auto endRow = [&](size_t end) {
+    for (size_t j = rowBegin; j < end; ++j) {
+      auto& item = layout.items[j];
+      int offset = (rowH - item.rect.h) / 2;
+      item.rect.y += offset;
+      item.textPos.y += offset;
+    }
+  };
+  for (size_t i = 0; i < N; ++i) {
+    auto item = items[i];
+    EdgeSize edge{};
+    SDL_Point textSize{};
+    if (item.kind == FormItemKind::BUTTON ||
+        item.kind == FormItemKind::TOGGLE) {
+      edge = style.button.padding + style.button.border;
+      textSize = measure(item.str, style.button.font, style.button.scale);
+    } else if (item.kind == FormItemKind::VALUE) {
+      edge = style.value.padding + style.value.border;
+      textSize = measure('X', style.value.font, style.value.scale);
+      textSize.x *= item.columns;
+    } else {
+      edge = style.label.padding + style.label.border;
+      textSize = measure(item.str, style.label.font, style.label.scale);
+    }
+    auto sz = elementSize(edge, textSize);
+    if (i > 0 && item.beside) {
+      x += style.elementSpacing;
+    } else if (i > 0) {
+      endRow(i);
+      rowY += rowH + style.elementSpacing;
+      rowH = 0;
+      rowBegin = i;
+      x = 0;
+    }
+    item.rect = {x, rowY, sz.x, sz.y};
+    item.textPos = {x + edge.left, rowY + edge.top};
+    x += sz.x;
+    rowH = std::max(rowH, sz.y);
+    layout.size.x = std::max(layout.size.x, x);
+    layout.size.y = rowY + rowH;
+    if (item.isBound()) {
+      layout.boundCount++;
+    }
+    layout.items[i] = item;
+  }
+  endRow(N);
+  return layout;
+}
+
+/// What a bound FormItem shows, either a toggle state or a text
+struct FormValue
+{
+  bool* toggle = nullptr;
+  std::string_view text;
+
+  constexpr FormValue(bool* toggle)
+    : toggle(toggle)
+  {}
+  constexpr FormValue(std::string_view text)
+    : text(text)
+  {}
+  constexpr FormValue(const char* text)
+    : text(text)
+  {}
+};
+
+/**
+ * @brief Add a form item, already placed
+ *
+ * You probably want staticForm() instead of this.
+ *
+ * @param target the form group
+ * @param item the item
+ * @param value the bound value, if the item is bound
+ * @param style
+ * @return true if it was actioned
+ */
+inline bool
+formItem(Target target,
+         const FormItem& item,
+         const FormValue* value,
+         const FormStyle& style)
+{
+  switch (item.kind) {
+  case FormItemKind::LABEL:
+    text(target, item.str, item.textPos, style.label);
+    box(target, item.rect, style.label);
+    return false;
+  case FormItemKind::VALUE: {
+    auto str = value ? value->text : std::string_view{};
+    auto right = style.value.padding.right + style.value.border.right;
+    int width = item.rect.x + item.rect.w - right - item.textPos.x;
+    ellipsizedText(target, str, item.textPos, width, style.value);
+    box(target, item.rect, style.value);
+    return false;
+  }
+  default:
+    break;
+  }
+  auto action = target.checkMouse(item.id, item.rect);
+  bool pushed = item.kind == FormItemKind::TOGGLE && value && value->toggle &&
+                *value->toggle;
+  auto& paint =
+    decideButtonColors(style.button, pushed, action == MouseAction::HOLD);
+  text(target,
+       item.str,
+       item.textPos,
+       TextStyle{style.button.font, paint.text, style.button.scale});
+  box(target, item.rect, BoxStyle{style.button.border, paint});
+  if (action != MouseAction::ACTION) {
+    return false;
+  }
+  if (item.kind == FormItemKind::TOGGLE && value && value->toggle) {
+    *value->toggle = !*value->toggle;
+  }
+  return true;
+}
+
+/**
+ * @brief Adds a form placed by layoutForm()
+ * @ingroup groups
+ *
+ * The form is a single group, where the items are added on their precomputed
+ * rects. Only the bound values and the mouse checks are evaluated per frame.
+ *
+ * @param target the parent group or frame
+ * @param id the form id
+ * @param layout the form, usually constexpr
+ * @param values the values of the bound items (formToggle() and formValue()),
+ * in the order they were declared
+ * @param p the form relative position
+ * @return int the index of the actioned item or -1 if none
+ */
+template<size_t N>
+inline int
+staticForm(Target target,
+           std::string_view id,
+           const FormLayout<N>& layout,
+           std::initializer_list<FormValue> values = {},
+           const SDL_Point& p = {0})
+{
+  SDL_assert(values.size() == layout.boundCount);
+  auto g = group(target,
+                 id,
+                 {p.x, p.y, layout.size.x, layout.size.y},
+                 Layout::NONE);
+  auto value = values.begin();
+  int actioned = -1;
+  for (size_t i = 0; i < N; ++i) {
+    auto& item = layout.items[i];
+    const FormValue* bound = nullptr;
+    if (item.isBound() && value != values.end()) {
+      bound = value++;
+    }
+    if (formItem(g, item, bound, layout.style)) {
+      actioned = int(i);
+    }
+  }
+  return actioned;
+}
+
+} // namespace dui
+
+#endif // DUI_FORM_HPP_
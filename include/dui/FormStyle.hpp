@@ -0,0 +1,61 @@
+#ifndef DUI_FORMSTYLE_HPP_
+#define DUI_FORMSTYLE_HPP_
+
+#include "ButtonStyle.hpp"
+#include "ElementStyle.hpp"
+#include "GroupStyle.hpp"
+#include "LabelStyle.hpp"
+#include "Theme.hpp"
+
+namespace dui {
+
+// Style for static forms
+struct FormStyle
+{
+  int elementSpacing;
+  ElementStyle label;
+  ButtonStyle button;
+  ElementStyle value;
+
+  constexpr FormStyle withElementSpacing(int elementSpacing) const
+  {
+    return {elementSpacing, label, button, value};
+  }
+  constexpr FormStyle withLabel(const ElementStyle& label) const
+  {
+    return {elementSpacing, label, button, value};
+  }
+  constexpr FormStyle withButton(const ButtonStyle& button) const
+  {
+    return {elementSpacing, label, button, value};
+  }
+  constexpr FormStyle withValue(const ElementStyle& value) const
+  {
+    return {elementSpacing, label, button, value};
+  }
+};
+
+struct Form;
+
+namespace style {
+
+template<class Theme>
+struct FromTheme<Form, Theme>
+{
+  constexpr static FormStyle get()
+  {
+    auto label = themeFor<Label, Theme>();
+    auto button = themeFor<Button, Theme>();
+    return {
+      themeFor<Group, Theme>().elementSpacing,
+      label,
+      button,
+      label.withBorder(EdgeSize::all(1)).withPaint(button.normal),
+    };
+  }
+};
+} // namespace style
+
+} // namespace dui
+
+#endif // DUI_FORMSTYLE_HPP_
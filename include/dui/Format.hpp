@@ -0,0 +1,187 @@
+#ifndef DUI_FORMAT_HPP_
+#define DUI_FORMAT_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <SDL.h>
+
+namespace dui {
+
+/// Where formatTo() writes, counting what does not fit
+class FormatBuffer
+{
+  char* buffer;
+  size_t capacity;
+  size_t size = 0;
+
+public:
+  FormatBuffer(char* buffer, size_t capacity)
+    : buffer(buffer)
+    , capacity(capacity)
+  {}
+
+  void append(std::string_view str)
+  {
+    if (size < capacity) {
+      auto n = std::min(str.size(), capacity - size);
+      std::memcpy(buffer + size, str.data(), n);
+    }
+    size += str.size();
+  }
+
+  void append(char ch)
+  {
+    if (size < capacity) {
+      buffer[size] = ch;
+    }
+    size++;
+  }
+
+  /// The size the whole text needs
+  size_t getSize() const { return size; }
+
+  /// If the whole text fit
+  bool fits() const { return size <= capacity; }
+
+  /// The text written, cut if it did not fit
+  std::string_view view() const { return {buffer, std::min(size, capacity)}; }
+};
+
+/**
+ * @brief Append a value
+ *
+ * Numbers are written with std::to_chars. Booleans are written as true or
+ * false and anything convertible to std::string_view as is.
+ *
+ * @param out the buffer
+ * @param value the value
+ * @param precision for floating point values, the digits after the point. If
+ * negative, the shortest text that reads back to the same value is used
+ */
+template<class T>
+void
+formatValue(FormatBuffer& out, const T& value, int precision = -1)
+{
+  if constexpr (std::is_same_v<T, bool>) {
+    out.append(value ? "true" : "false");
+  } else if constexpr (std::is_same_v<T, char>) {
+    out.append(value);
+  } else if constexpr (std::is_integral_v<T>) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append({digits, size_t(result.ptr - digits)});
+  } else if constexpr (std::is_floating_point_v<T>) {
+    char digits[128];
+#ifdef __cpp_lib_to_chars
+    auto result = precision < 0
+                    ? std::to_chars(digits, digits + sizeof(digits), value)
+                    : std::to_chars(digits,
+                                    digits + sizeof(digits),
+                                    value,
+                                    std::chars_format::fixed,
+                                    precision);
+    if (result.ec != std::errc{}) {
+      result = std::to_chars(digits,
+                             digits + sizeof(digits),
+                             value,
+                             std::chars_format::scientific);
+    }
+    out.append({digits, size_t(result.ptr - digits)});
+#else
+    // Floating point std::to_chars is missing on older standard libraries
+    int n = precision < 0
+              ? SDL_snprintf(digits, sizeof(digits), "%g", double(value))
+              : SDL_snprintf(
+                  digits, sizeof(digits), "%.*f", precision, double(value));
+    out.append({digits, std::min(size_t(n), sizeof(digits) - 1)});
+#endif
+  } else {
+    static_assert(std::is_convertible_v<const T&, std::string_view>,
+                  "Type can not be formatted");
+    out.append(std::string_view{value});
+  }
+}
+
+/**
+ * @brief Append the text up to the next placeholder
+ *
+ * @param out the buffer
+ * @param fmt the format, it gets what is after the placeholder
+ * @param precision receives the placeholder precision, or -1
+ * @return true if a placeholder was found
+ */
+inline bool
+formatLiteral(FormatBuffer& out, std::string_view& fmt, int& precision)
+{
+  for (size_t i = 0; i < fmt.size(); ++i) {
+    char ch = fmt[i];
+    if ((ch == '{' || ch == '}') && i + 1 < fmt.size() && fmt[i + 1] == ch) {
+      out.append(ch);
+      i++;
+      continue;
+    }
+    auto close = ch == '{' ? fmt.find('}', i) : fmt.npos;
+    if (close == fmt.npos) {
+      out.append(ch);
+      continue;
+    }
+    precision = -1;
+    auto spec = fmt.substr(i + 1, close - i - 1);
+    if (spec.size() > 2 && spec[0] == ':' && spec[1] == '.') {
+      precision = 0;
+      for (auto digit : spec.substr(2)) {
+        if (digit >= '0' && digit <= '9') {
+          precision = precision * 10 + digit - '0';
+        }
+      }
+    }
+    fmt.remove_prefix(close + 1);
+    return true;
+  }
+  fmt = {};
+  return false;
+}
+
+/// Append the format with no more arguments, leaving its placeholders as is
+inline void
+formatTo(FormatBuffer& out, std::string_view fmt)
+{
+  int precision;
+  while (formatLiteral(out, fmt, precision)) {
+    out.append("{}");
+  }
+}
+
+/**
+ * @brief Append a formatted text
+ *
+ * Each placeholder "{}" is replaced by the next argument, formatted by
+ * formatValue(). A "{:.N}" placeholder writes floating point values with N
+ * digits after the point. Use "{{" and "}}" for literal braces.
+ *
+ * @param out the buffer
+ * @param fmt the format
+ * @param arg the first argument
+ * @param args the other arguments
+ */
+template<class ARG, class... ARGS>
+void
+formatTo(FormatBuffer& out,
+         std::string_view fmt,
+         const ARG& arg,
+         const ARGS&... args)
+{
+  int precision;
+  if (!formatLiteral(out, fmt, precision)) {
+    return;
+  }
+  formatValue(out, arg, precision);
+  formatTo(out, fmt, args...);
+}
+
+} // namespace dui
+
+#endif // DUI_FORMAT_HPP_
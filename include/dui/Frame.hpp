@@ -70,7 +70,8 @@ frame(State& state)
   return {&state};
 }
 
-inline Frame::Frame(State* state)
+#ifdef DUI_DEFINITIONS
+DUI_INLINE Frame::Frame(State* state)
   : state(state)
   , rect({0, 0, 0, 0})
   , topLeft({0, 0})
@@ -79,12 +80,13 @@ inline Frame::Frame(State* state)
   state->beginFrame();
 }
 
-inline void
+DUI_INLINE void
 Frame::end()
 {
   state->endFrame();
   locked = false;
 }
+#endif // DUI_DEFINITIONS
 
 } // namespace dui
 
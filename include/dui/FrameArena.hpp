@@ -0,0 +1,103 @@
+#ifndef DUI_FRAMEARENA_HPP_
+#define DUI_FRAMEARENA_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <SDL.h>
+#include "Config.hpp"
+
+namespace dui {
+
+/**
+ * @brief Memory for strings that last until the frame ends
+ *
+ * It is reset on each frame begin. Its blocks are kept between frames, so once
+ * they fit a frame's strings nothing else is allocated. On bounded memory it is
+ * a single buffer of DUI_MAX_FRAME_TEXT bytes.
+ */
+class FrameArena
+{
+#ifdef DUI_BOUNDED_MEMORY
+  char buffer[DUI_MAX_FRAME_TEXT];
+  size_t used = 0;
+#else
+  struct Block
+  {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+  std::vector<Block> blocks;
+  size_t current = 0; // The block being used
+  size_t used = 0;    // Bytes used on the current block
+
+  static constexpr size_t BLOCK_SIZE = 4096;
+#endif
+
+public:
+  /// A free area
+  struct Space
+  {
+    char* data;
+    size_t size;
+  };
+
+  /**
+   * @brief Get the free space, moving to a new block if needed
+   *
+   * Nothing is used until commit() is called.
+   *
+   * @param minimum the bytes wanted. On bounded memory the space might be
+   * smaller
+   * @return Space
+   */
+  Space space(size_t minimum)
+  {
+#ifdef DUI_BOUNDED_MEMORY
+    return {buffer + used, DUI_MAX_FRAME_TEXT - used};
+#else
+    if (current < blocks.size()) {
+      size_t left = blocks[current].size - used;
+      if (left > 0 && left >= minimum) {
+        return {blocks[current].data.get() + used, left};
+      }
+      current++;
+      used = 0;
+    }
+    size_t size = std::max(minimum, BLOCK_SIZE);
+    if (current == blocks.size()) {
+      blocks.push_back({nullptr, 0});
+    }
+    auto& block = blocks[current];
+    if (block.size < size) {
+      block.data.reset(new char[size]);
+      block.size = size;
+    }
+    return {block.data.get(), block.size};
+#endif
+  }
+
+  /// Use the given bytes from the last space()
+  void commit(size_t size)
+  {
+    used += size;
+#ifdef DUI_BOUNDED_MEMORY
+    SDL_assert(used <= DUI_MAX_FRAME_TEXT);
+#else
+    SDL_assert(current < blocks.size() && used <= blocks[current].size);
+#endif
+  }
+
+  /// Release all strings, keeping the memory
+  void reset()
+  {
+    used = 0;
+#ifndef DUI_BOUNDED_MEMORY
+    current = 0;
+#endif
+  }
+};
+
+} // namespace dui
+
+#endif // DUI_FRAMEARENA_HPP_
@@ -0,0 +1,26 @@
+#ifndef DUI_FRAMESTATS_HPP_
+#define DUI_FRAMESTATS_HPP_
+
+namespace dui {
+
+/**
+ * @brief Counters collected while building and rendering a frame
+ *
+ * They are reset at every frame and can be read after the frame was rendered
+ * through State.getFrameStats().
+ */
+struct FrameStats
+{
+  int shapes;            ///< Shapes drawn on last render
+  int renderCalls;       ///< SDL render calls issued on last render
+  int savedCalls;        ///< Redundant SDL render calls elided on last render
+  int culledShapes;      ///< Shapes removed by occlusion culling
+  int optimizedCommands; ///< Commands removed by DisplayList.optimize()
+  int droppedCommands;   ///< Commands that did not fit the display list
+  int droppedIds;        ///< Ids that did not fit the id buffers
+  int updates;           ///< Updates from State.post() applied on frame begin
+};
+
+} // namespace dui
+
+#endif // DUI_FRAMESTATS_HPP_
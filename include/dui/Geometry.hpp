@@ -0,0 +1,579 @@
+#ifndef DUI_GEOMETRY_HPP_
+#define DUI_GEOMETRY_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <SDL.h>
+#include "DisplayList.hpp"
+#include "Target.hpp"
+
+namespace dui {
+
+/**
+ * @brief Tessellation of vector shapes into anti-aliased triangles
+ *
+ * The edges fade out over a pixel, with fringe triangles whose outer vertices
+ * are transparent. Points are given by a function taking the point index and
+ * returning a Vertex, whose color is ignored.
+ */
+namespace geometry {
+
+/// Kinds of shapes, the first value on State.tessellate() keys
+enum Kind : Uint32
+{
+  STROKE,
+  CLOSED_STROKE,
+  POLYGON,
+  CIRCLE,
+  ROUNDED_BOX,
+};
+
+/// Max points of a polygon triangulated by fillPolygon()
+constexpr size_t MAX_POLYGON_POINTS = 1024;
+
+/// Points on the unit circle, shared by all round shapes
+struct UnitCircle
+{
+  static constexpr int SIZE = 256;
+  float x[SIZE];
+  float y[SIZE];
+};
+
+inline const UnitCircle&
+unitCircle()
+{
+  static const UnitCircle circle = [] {
+    constexpr double PI = 3.14159265358979323846;
+    UnitCircle c;
+    for (int i = 0; i < UnitCircle::SIZE; ++i) {
+      double angle = 2 * PI * i / UnitCircle::SIZE;
+      c.x[i] = float(std::cos(angle));
+      c.y[i] = float(std::sin(angle));
+    }
+    return c;
+  }();
+  return circle;
+}
+
+/// Number of segments of a full circle with the given radius
+inline int
+circleSegments(float radius)
+{
+  // Segments up to 3 pixels long
+  int segments = 16;
+  while (segments < UnitCircle::SIZE && segments * 3 < 6.2832f * radius) {
+    segments *= 2;
+  }
+  return segments;
+}
+
+/// The bits of a float, to be used on keys
+inline Uint32
+bits(float value)
+{
+  Uint32 result;
+  std::memcpy(&result, &value, sizeof(result));
+  return result;
+}
+
+/// A color packed to be used on keys
+constexpr Uint32
+pack(SDL_Color c)
+{
+  return Uint32(c.r) << 24 | Uint32(c.g) << 16 | Uint32(c.b) << 8 | c.a;
+}
+
+/// Twice the signed area, positive if clockwise on screen
+template<class AT>
+float
+signedArea(AT at, size_t count)
+{
+  float area = 0;
+  for (size_t i = 0; i < count; ++i) {
+    auto a = at(i);
+    auto b = at((i + 1) % count);
+    area += a.x * b.y - b.x * a.y;
+  }
+  return area;
+}
+
+/**
+ * @brief Offset of a point that moves its segments 1 pixel sideways
+ *
+ * On outlines clockwise on screen it points outwards. Sharp corners are
+ * limited to 2 pixels.
+ */
+template<class AT>
+Vertex
+miter(AT at, size_t count, bool closed, size_t i)
+{
+  auto normal = [&](size_t a, size_t b) {
+    auto p = at(a);
+    auto q = at(b);
+    float dx = q.x - p.x;
+    float dy = q.y - p.y;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length > 0) {
+      dx /= length;
+      dy /= length;
+    }
+    return Vertex{dy, -dx, {}};
+  };
+  size_t prev = i > 0 ? i - 1 : count - 1;
+  size_t next = i + 1 < count ? i + 1 : 0;
+  bool hasPrev = closed || i > 0;
+  bool hasNext = closed || i + 1 < count;
+  auto n0 = hasPrev ? normal(prev, i) : normal(i, next);
+  auto n1 = hasNext ? normal(i, next) : n0;
+  float x = (n0.x + n1.x) / 2;
+  float y = (n0.y + n1.y) / 2;
+  float d2 = x * x + y * y;
+  if (d2 < 1e-6f) {
+    return n0;
+  }
+  float scale = std::min(1 / d2, 4.f);
+  return {x * scale, y * scale, {}};
+}
+
+template<class BUFFER>
+void
+quad(BUFFER& out,
+     const Vertex& a,
+     const Vertex& b,
+     const Vertex& c,
+     const Vertex& d)
+{
+  out.push_back(a);
+  out.push_back(b);
+  out.push_back(c);
+  out.push_back(a);
+  out.push_back(c);
+  out.push_back(d);
+}
+
+/// Stroke the lines connecting the points
+template<class AT, class BUFFER>
+void
+stroke(AT at,
+       size_t count,
+       bool closed,
+       float thickness,
+       SDL_Color c,
+       BUFFER& out)
+{
+  size_t segments = closed ? count : count - 1;
+  // The core is opaque and each side fades out over a pixel. Thin lines get
+  // more transparent instead
+  float core = std::max(thickness * 0.5f - 0.5f, 0.f);
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+  // There only the opaque core is drawn, so it must be at least a pixel wide
+  core = std::max(core, 0.5f);
+#endif
+  if (thickness < 1) {
+    c.a = Uint8(c.a * thickness);
+  }
+  SDL_Color clear{c.r, c.g, c.b, 0};
+  if (count < 2 || out.max_size() - out.size() < segments * 18) {
+    return;
+  }
+  auto offset = [&](size_t i, const Vertex& m, float d, SDL_Color color) {
+    auto p = at(i);
+    return Vertex{p.x + m.x * d, p.y + m.y * d, color};
+  };
+  auto m0 = miter(at, count, closed, 0);
+  for (size_t i = 0; i < segments; ++i) {
+    size_t j = (i + 1) % count;
+    auto m1 = miter(at, count, closed, j);
+    auto leftIn0 = offset(i, m0, core, c);
+    auto leftIn1 = offset(j, m1, core, c);
+    auto rightIn0 = offset(i, m0, -core, c);
+    auto rightIn1 = offset(j, m1, -core, c);
+    quad(out,
+         offset(i, m0, core + 1, clear),
+         offset(j, m1, core + 1, clear),
+         leftIn1,
+         leftIn0);
+    if (core > 0) {
+      quad(out, leftIn0, leftIn1, rightIn1, rightIn0);
+    }
+    quad(out,
+         rightIn0,
+         rightIn1,
+         offset(j, m1, -core - 1, clear),
+         offset(i, m0, -core - 1, clear));
+    m0 = m1;
+  }
+}
+
+/// Fill a convex outline, with edges centered on its points
+template<class AT, class BUFFER>
+void
+fillConvex(AT at, size_t count, SDL_Color c, BUFFER& out)
+{
+  if (count < 3 || out.max_size() - out.size() < count * 9) {
+    return;
+  }
+  float side = signedArea(at, count) < 0 ? -0.5f : 0.5f;
+  SDL_Color clear{c.r, c.g, c.b, 0};
+  auto inner = [&](size_t i) {
+    auto p = at(i);
+    auto m = miter(at, count, true, i);
+    return Vertex{p.x - m.x * side, p.y - m.y * side, c};
+  };
+  auto outer = [&](size_t i) {
+    auto p = at(i);
+    auto m = miter(at, count, true, i);
+    return Vertex{p.x + m.x * side, p.y + m.y * side, clear};
+  };
+  auto first = inner(0);
+  auto last = inner(1);
+  for (size_t i = 2; i < count; ++i) {
+    auto next = inner(i);
+    out.push_back(first);
+    out.push_back(last);
+    out.push_back(next);
+    last = next;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    size_t j = (i + 1) % count;
+    quad(out, inner(i), inner(j), outer(j), outer(i));
+  }
+}
+
+/**
+ * @brief Fill a simple polygon, convex or not, fading out of its points
+ *
+ * It is triangulated by ear clipping. Polygons with more than
+ * MAX_POLYGON_POINTS or with crossing edges get a fan instead, which is only
+ * right for convex ones.
+ */
+template<class AT, class BUFFER>
+void
+fillPolygon(AT at, size_t count, SDL_Color c, BUFFER& out)
+{
+  if (count < 3 || out.max_size() - out.size() < count * 9) {
+    return;
+  }
+  float area = signedArea(at, count);
+  float sign = area < 0 ? -1.f : 1.f;
+  auto emit = [&](size_t a, size_t b, size_t d) {
+    for (auto i : {a, b, d}) {
+      auto p = at(i);
+      out.push_back({p.x, p.y, c});
+    }
+  };
+  Uint16 indices[MAX_POLYGON_POINTS];
+  size_t remaining = count <= MAX_POLYGON_POINTS ? count : 0;
+  for (size_t i = 0; i < remaining; ++i) {
+    indices[i] = Uint16(i);
+  }
+  auto cross = [](const Vertex& a, const Vertex& b, const Vertex& d) {
+    return (b.x - a.x) * (d.y - b.y) - (b.y - a.y) * (d.x - b.x);
+  };
+  size_t k = 0;
+  size_t misses = 0;
+  while (remaining > 3 && misses < remaining) {
+    k %= remaining;
+    size_t ia = indices[(k + remaining - 1) % remaining];
+    size_t ib = indices[k];
+    size_t id = indices[(k + 1) % remaining];
+    auto a = at(ia);
+    auto b = at(ib);
+    auto d = at(id);
+    bool ear = cross(a, b, d) * sign > 0;
+    for (size_t i = 0; ear && i < remaining; ++i) {
+      size_t ip = indices[i];
+      if (ip == ia || ip == ib || ip == id) {
+        continue;
+      }
+      auto p = at(ip);
+      ear = !(cross(a, b, p) * sign >= 0 && cross(b, d, p) * sign >= 0 &&
+              cross(d, a, p) * sign >= 0);
+    }
+    if (!ear) {
+      k++;
+      misses++;
+      continue;
+    }
+    emit(ia, ib, id);
+    std::copy(indices + k + 1, indices + remaining, indices + k);
+    remaining--;
+    misses = 0;
+  }
+  if (count > MAX_POLYGON_POINTS) {
+    for (size_t i = 2; i < count; ++i) {
+      emit(0, i - 1, i);
+    }
+  } else {
+    for (size_t i = 2; i < remaining; ++i) {
+      emit(indices[0], indices[i - 1], indices[i]);
+    }
+  }
+  SDL_Color clear{c.r, c.g, c.b, 0};
+  for (size_t i = 0; i < count; ++i) {
+    size_t j = (i + 1) % count;
+    auto p = at(i);
+    auto q = at(j);
+    auto m0 = miter(at, count, true, i);
+    auto m1 = miter(at, count, true, j);
+    quad(out,
+         {p.x, p.y, c},
+         {q.x, q.y, c},
+         {q.x + m1.x * sign, q.y + m1.y * sign, clear},
+         {p.x + m0.x * sign, p.y + m0.y * sign, clear});
+  }
+}
+
+/**
+ * @brief Points of a rect with rounded corners, clockwise from the top left
+ *
+ * @param w the width
+ * @param h the height
+ * @param radius the corner radius, up to half the smallest side
+ * @param result receives the points, it must have room for
+ * UnitCircle::SIZE + 4 points
+ * @return size_t the number of points
+ */
+inline size_t
+roundedOutline(float w, float h, float radius, Vertex* result)
+{
+  auto& circle = unitCircle();
+  radius = std::clamp(radius, 0.f, std::min(w, h) / 2);
+  int quarter = circleSegments(radius) / 4;
+  int step = UnitCircle::SIZE / 4 / quarter;
+  Vertex centers[4] = {{radius, radius, {}},
+                       {w - radius, radius, {}},
+                       {w - radius, h - radius, {}},
+                       {radius, h - radius, {}}};
+  size_t count = 0;
+  for (int corner = 0; corner < 4; ++corner) {
+    // Starting at 180 degrees, clockwise on screen
+    int start = (corner + 2) * UnitCircle::SIZE / 4;
+    for (int i = 0; i <= quarter; ++i) {
+      int index = (start + i * step) % UnitCircle::SIZE;
+      Vertex p{centers[corner].x + circle.x[index] * radius,
+               centers[corner].y + circle.y[index] * radius,
+               {}};
+      if (count > 0 && std::abs(p.x - result[count - 1].x) < 1e-3f &&
+          std::abs(p.y - result[count - 1].y) < 1e-3f) {
+        continue;
+      }
+      result[count++] = p;
+      if (radius == 0) {
+        break;
+      }
+    }
+  }
+  return count;
+}
+
+} // namespace geometry
+
+/**
+ * @brief adds an anti-aliased polyline to target
+ * @ingroup elements
+ *
+ * It is tessellated into triangles, cached while the points relative to the
+ * first one, the thickness and the color do not change.
+ *
+ * @param target the parent group or frame
+ * @param points the local points, at least 2. The lines go through the pixel
+ * centers
+ * @param count the number of points
+ * @param c the line color
+ * @param thickness the line thickness, in pixels
+ * @param closed if the last point connects to the first
+ */
+inline void
+strokePolyline(Target target,
+               const SDL_Point* points,
+               size_t count,
+               SDL_Color c,
+               float thickness,
+               bool closed = false)
+{
+  auto& state = target.getState();
+  SDL_assert(state.isInFrame());
+  SDL_assert(!target.isLocked());
+  if (count < 2 || c.a == 0 || thickness <= 0) {
+    return;
+  }
+  auto caret = target.getCaret();
+  SDL_Point bottomRight = points[0];
+  for (size_t i = 1; i < count; ++i) {
+    bottomRight.x = std::max(bottomRight.x, points[i].x);
+    bottomRight.y = std::max(bottomRight.y, points[i].y);
+  }
+  int extent = int(std::ceil(thickness / 2)) + 1;
+  target.advance({bottomRight.x + extent, bottomRight.y + extent});
+  auto origin = points[0];
+  auto at = [&](size_t i) {
+    return Vertex{points[i].x - origin.x + 0.5f,
+                  points[i].y - origin.y + 0.5f,
+                  {}};
+  };
+  auto kind = closed ? geometry::CLOSED_STROKE : geometry::STROKE;
+  auto& v = state.tessellate(
+    {kind, geometry::bits(thickness), geometry::pack(c)},
+    points,
+    count,
+    [&](VertexBuffer& out) {
+      geometry::stroke(at, count, closed, thickness, c, out);
+    });
+  if (v.size() > 0) {
+    state.displayGeometry(
+      &v[0], v.size(), {caret.x + origin.x, caret.y + origin.y});
+  }
+}
+
+/**
+ * @brief adds an anti-aliased line segment to target
+ * @ingroup elements
+ *
+ * @param target the parent group or frame
+ * @param a the local start point
+ * @param b the local end point
+ * @param c the line color
+ * @param thickness the line thickness, in pixels
+ */
+inline void
+line(Target target,
+     const SDL_Point& a,
+     const SDL_Point& b,
+     SDL_Color c,
+     float thickness = 1)
+{
+  SDL_Point points[] = {a, b};
+  strokePolyline(target, points, 2, c, thickness);
+}
+
+/**
+ * @brief adds a filled anti-aliased polygon to target
+ * @ingroup elements
+ *
+ * It can be concave, but its edges must not cross. @see
+ * geometry::fillPolygon()
+ *
+ * @param target the parent group or frame
+ * @param points the local corners, at least 3
+ * @param count the number of points
+ * @param c the fill color
+ */
+inline void
+polygon(Target target, const SDL_Point* points, size_t count, SDL_Color c)
+{
+  auto& state = target.getState();
+  SDL_assert(state.isInFrame());
+  SDL_assert(!target.isLocked());
+  if (count < 3 || c.a == 0) {
+    return;
+  }
+  auto caret = target.getCaret();
+  SDL_Point bottomRight = points[0];
+  for (size_t i = 1; i < count; ++i) {
+    bottomRight.x = std::max(bottomRight.x, points[i].x);
+    bottomRight.y = std::max(bottomRight.y, points[i].y);
+  }
+  target.advance({bottomRight.x + 1, bottomRight.y + 1});
+  auto origin = points[0];
+  auto at = [&](size_t i) {
+    return Vertex{
+      float(points[i].x - origin.x), float(points[i].y - origin.y), {}};
+  };
+  auto& v = state.tessellate(
+    {geometry::POLYGON, geometry::pack(c)},
+    points,
+    count,
+    [&](VertexBuffer& out) { geometry::fillPolygon(at, count, c, out); });
+  if (v.size() > 0) {
+    state.displayGeometry(
+      &v[0], v.size(), {caret.x + origin.x, caret.y + origin.y});
+  }
+}
+
+/**
+ * @brief adds a filled anti-aliased circle to target
+ * @ingroup elements
+ *
+ * @param target the parent group or frame
+ * @param center the local center pixel
+ * @param radius the radius, the circle covers 2 * radius + 1 pixels across
+ * @param c the fill color
+ */
+inline void
+circle(Target target, const SDL_Point& center, int radius, SDL_Color c)
+{
+  auto& state = target.getState();
+  SDL_assert(state.isInFrame());
+  SDL_assert(!target.isLocked());
+  if (radius < 0 || c.a == 0) {
+    return;
+  }
+  auto caret = target.getCaret();
+  target.advance({center.x + radius + 1, center.y + radius + 1});
+  auto& v = state.tessellate(
+    {geometry::CIRCLE, Uint32(radius), geometry::pack(c)},
+    nullptr,
+    0,
+    [&](VertexBuffer& out) {
+      auto& unit = geometry::unitCircle();
+      float r = radius + 0.5f;
+      int segments = geometry::circleSegments(r);
+      int step = geometry::UnitCircle::SIZE / segments;
+      auto at = [&](size_t i) {
+        return Vertex{0.5f + unit.x[i * step] * r,
+                      0.5f + unit.y[i * step] * r,
+                      {}};
+      };
+      geometry::fillConvex(at, segments, c, out);
+    });
+  if (v.size() > 0) {
+    state.displayGeometry(
+      &v[0], v.size(), {caret.x + center.x, caret.y + center.y});
+  }
+}
+
+/**
+ * @brief adds a filled anti-aliased box with rounded corners to target
+ * @ingroup elements
+ *
+ * @param target the parent group or frame
+ * @param r the box local position and size
+ * @param radius the corners radius, up to half the smallest side
+ * @param c the fill color
+ */
+inline void
+roundedBox(Target target, const SDL_Rect& r, int radius, SDL_Color c)
+{
+  auto& state = target.getState();
+  SDL_assert(state.isInFrame());
+  SDL_assert(!target.isLocked());
+  if (r.w <= 0 || r.h <= 0 || c.a == 0) {
+    return;
+  }
+  auto caret = target.getCaret();
+  target.advance({r.x + r.w, r.y + r.h});
+  auto& v = state.tessellate(
+    {geometry::ROUNDED_BOX,
+     Uint32(r.w),
+     Uint32(r.h),
+     Uint32(radius),
+     geometry::pack(c)},
+    nullptr,
+    0,
+    [&](VertexBuffer& out) {
+      Vertex outline[geometry::UnitCircle::SIZE + 4];
+      auto count = geometry::roundedOutline(
+        float(r.w), float(r.h), float(radius), outline);
+      auto at = [&](size_t i) { return outline[i]; };
+      geometry::fillConvex(at, count, c, out);
+    });
+  if (v.size() > 0) {
+    state.displayGeometry(&v[0], v.size(), {caret.x + r.x, caret.y + r.y});
+  }
+}
+
+} // namespace dui
+
+#endif // DUI_GEOMETRY_HPP_
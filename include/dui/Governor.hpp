@@ -0,0 +1,79 @@
+#ifndef DUI_GOVERNOR_HPP_
+#define DUI_GOVERNOR_HPP_
+
+#include <SDL.h>
+
+namespace dui {
+
+/**
+ * @brief The decisions of the frame budget governor
+ *
+ * When the frames take longer than the budget set by State.setFrameBudget(),
+ * the level is raised and the ui does less work. It is lowered again once the
+ * frames are well under the budget. See State.getGovernor().
+ */
+struct Governor
+{
+  static constexpr int MAX_LEVEL = 3;
+  static constexpr int RAISE_DELAY = 8;  ///< Min frames before a raise
+  static constexpr int LOWER_DELAY = 60; ///< Min frames before a lower
+
+  int level = 0;          ///< From 0 (full work) to MAX_LEVEL
+  Uint32 frameTime = 0;   ///< Smoothed build plus render time, in microseconds
+  Uint32 buildTime = 0;   ///< Last frame build time, in microseconds
+  Uint32 renderTime = 0;  ///< Last frame render time, in microseconds
+  bool animating = true;  ///< If animations and the cursor blink run
+  int memoInterval = 1;   ///< Frames a changed memo() may still be replayed
+  int scrollInterval = 1; ///< Frames between rebuilds of hidden scrollables
+  int changes = 0;        ///< Number of level changes so far
+  int frames = 0;         ///< Frames since last level change
+
+  /// Set the decisions for the given level
+  void setLevel(int value)
+  {
+    level = value;
+    animating = level < 1;
+    memoInterval = level < 2 ? 1 : level < 3 ? 4 : 8;
+    scrollInterval = level < 3 ? 1 : 8;
+  }
+
+  /**
+   * @brief Account a frame and change the level if needed
+   *
+   * The level is raised if the smoothed time is over the budget and lowered
+   * if it is under 60% of it. Changes are spaced, so the effect of the last
+   * one is seen before the next.
+   *
+   * @param build the frame build time, in microseconds
+   * @param render the frame render time, in microseconds
+   * @param budget the budget, in microseconds. If 0 the level is always 0
+   */
+  void update(Uint32 build, Uint32 render, Uint32 budget)
+  {
+    buildTime = build;
+    renderTime = render;
+    frameTime = frameTime - frameTime / 8 + (build + render) / 8;
+    frames++;
+    int wanted = level;
+    if (budget == 0) {
+      wanted = 0;
+    } else if (frameTime > budget) {
+      if (level < MAX_LEVEL && frames >= RAISE_DELAY) {
+        wanted = level + 1;
+      }
+    } else if (frameTime < budget / 10 * 6) {
+      if (level > 0 && frames >= LOWER_DELAY) {
+        wanted = level - 1;
+      }
+    }
+    if (wanted != level) {
+      setLevel(wanted);
+      changes++;
+      frames = 0;
+    }
+  }
+};
+
+} // namespace dui
+
+#endif // DUI_GOVERNOR_HPP_
@@ -147,7 +147,8 @@ offsetGroup(Target target,
   return offsetGroup(target, id, scrollOffset, r, style.withLayout(layout));
 }
 
-inline Group::Group(Target parent,
+#ifdef DUI_DEFINITIONS
+DUI_INLINE Group::Group(Target parent,
                     std::string_view id,
                     const SDL_Point& scroll,
                     const SDL_Rect& rect,
@@ -162,7 +163,7 @@ inline Group::Group(Target parent,
   parent.lock(id, rect);
 }
 
-inline void
+DUI_INLINE void
 Group::end()
 {
   SDL_assert(!ended);
@@ -178,7 +179,7 @@ Group::end()
   parent = {};
 }
 
-inline Group::Group(Group&& rhs)
+DUI_INLINE Group::Group(Group&& rhs)
   : parent(rhs.parent)
   , id(std::move(rhs.id))
   , rect(rhs.rect)
@@ -188,7 +189,7 @@ inline Group::Group(Group&& rhs)
   rhs.ended = true;
 }
 
-inline Group&
+DUI_INLINE Group&
 Group::operator=(Group&& rhs)
 {
   SDL_assert(ended);
@@ -196,5 +197,6 @@ Group::operator=(Group&& rhs)
   new (this) Group(std::move(rhs));
   return *this;
 }
+#endif // DUI_DEFINITIONS
 
 } // namespace dui
@@ -0,0 +1,264 @@
+#ifndef DUI_HEATMAP_HPP_
+#define DUI_HEATMAP_HPP_
+
+#include <algorithm>
+#include <cstring>
+#include <SDL.h>
+#include "Box.hpp"
+#include "Group.hpp"
+#include "HeatmapStyle.hpp"
+#include "Text.hpp"
+
+namespace dui {
+
+/// A grid of values shown by heatmap(). It does not own the values
+struct ScalarField
+{
+  const float* values; ///< The values, row by row
+  int width;           ///< Values per row
+  int height;          ///< Number of rows
+  float min;           ///< Value shown with the low color
+  float max;           ///< Value shown with the high color
+
+  /// The value at the given column and row
+  float at(int x, int y) const { return values[size_t(y) * width + x]; }
+};
+
+/**
+ * @brief The texture of a heatmap(), kept between frames
+ *
+ * Only the rows marked dirty since last frame are colored and uploaded, so
+ * fields changing a few rows at a time are cheap. Everything is uploaded
+ * again if the field size, range or values pointer or the style colors
+ * change.
+ */
+class HeatmapTexture
+{
+public:
+  static constexpr int LUT_SIZE = 256;
+
+private:
+  SDL_Texture* texture = nullptr;
+  int width = 0;
+  int height = 0;
+  int dirtyBegin = 0;
+  int dirtyEnd = 0;
+  const float* values = nullptr;
+  float min = 0;
+  float max = 0;
+  SDL_Color colors[3] = {};
+  Uint32 lut[LUT_SIZE] = {};
+
+  static constexpr int BLOCK = 256;
+
+  void buildLut(const HeatmapStyle& style);
+  void colorRow(const float* src, Uint32* dst, int count) const;
+
+public:
+  HeatmapTexture() = default;
+  HeatmapTexture(const HeatmapTexture&) = delete;
+  HeatmapTexture& operator=(const HeatmapTexture&) = delete;
+  ~HeatmapTexture()
+  {
+    if (texture) {
+      SDL_DestroyTexture(texture);
+    }
+  }
+
+  /// Mark the rows from begin to end (exclusive) as changed
+  void markDirty(int begin, int end)
+  {
+    if (dirtyBegin >= dirtyEnd) {
+      dirtyBegin = begin;
+      dirtyEnd = end;
+      return;
+    }
+    dirtyBegin = std::min(dirtyBegin, begin);
+    dirtyEnd = std::max(dirtyEnd, end);
+  }
+
+  /// Mark all rows as changed
+  void markAllDirty() { markDirty(0, height); }
+
+  /**
+   * @brief Color and upload the dirty rows
+   *
+   * It must be called from the thread owning the renderer, so not inside
+   * parallel() contents.
+   *
+   * @param renderer the renderer
+   * @param field the values
+   * @param style the colors
+   * @return SDL_Texture* the texture, or nullptr if it could not be created
+   */
+  SDL_Texture* update(SDL_Renderer* renderer,
+                      const ScalarField& field,
+                      const HeatmapStyle& style);
+
+  /// The texture, as of last update()
+  SDL_Texture* getTexture() const { return texture; }
+};
+
+/**
+ * @brief A heatmap of a scalar field
+ * @ingroup elements
+ *
+ * It is drawn as a single texture, stretched to the client area. The dirty
+ * rows of the field must be marked on the HeatmapTexture before calling it.
+ *
+ * @param target the parent group or frame
+ * @param field the values
+ * @param map the texture, kept between frames
+ * @param r the position and size
+ * @param style
+ */
+inline void
+heatmap(Target target,
+        const ScalarField& field,
+        HeatmapTexture* map,
+        const SDL_Rect& r,
+        const HeatmapStyle& style = themeFor<Heatmap>())
+{
+  SDL_assert(map != nullptr);
+  auto g = group(target, {}, r, Layout::NONE);
+  auto& state = g.getState();
+  auto& border = style.box.border;
+  SDL_Rect client{border.left,
+                  border.top,
+                  r.w - border.left - border.right,
+                  r.h - border.top - border.bottom};
+  auto texture = map->update(state.getRenderer(), field, style);
+  auto mouse = Target{g}.lastMousePos();
+  // Not through what covers it
+  if (style.probing && texture && client.w > 0 && client.h > 0 &&
+      Target{g}.isHovered(client)) {
+    int x = (mouse.x - client.x) * field.width / client.w;
+    int y = (mouse.y - client.y) * field.height / client.h;
+    char probe[48];
+    SDL_snprintf(probe, sizeof(probe), "%d,%d: %g", x, y, field.at(x, y));
+    auto& font = style.probe.font.texture ? style.probe.font : state.getFont();
+    auto size = measure(probe, font, style.probe.scale);
+    SDL_Rect rect{mouse.x + 8, mouse.y + 8, size.x + 4, size.y + 2};
+    rect.x = std::max(std::min(rect.x, client.x + client.w - rect.w), 0);
+    rect.y = std::max(std::min(rect.y, client.y + client.h - rect.h), 0);
+    text(g, probe, {rect.x + 2, rect.y + 1}, style.probe);
+    colorBox(g, rect, style.probeBackground);
+  }
+  if (texture) {
+    textureBox(g, texture, client);
+  }
+  box(g, {0, 0, r.w, r.h}, style.box);
+}
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE SDL_Texture*
+HeatmapTexture::update(SDL_Renderer* renderer,
+                       const ScalarField& field,
+                       const HeatmapStyle& style)
+{
+  if (field.width <= 0 || field.height <= 0) {
+    return nullptr;
+  }
+  if (!texture || width != field.width || height != field.height) {
+    if (texture) {
+      SDL_DestroyTexture(texture);
+    }
+    texture = SDL_CreateTexture(renderer,
+                                SDL_PIXELFORMAT_RGBA32,
+                                SDL_TEXTUREACCESS_STREAMING,
+                                field.width,
+                                field.height);
+    if (!texture) {
+      width = height = 0;
+      return nullptr;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    width = field.width;
+    height = field.height;
+    markAllDirty();
+  }
+  auto sameColor = [](SDL_Color a, SDL_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+  };
+  if (!sameColor(colors[0], style.low) || !sameColor(colors[1], style.mid) ||
+      !sameColor(colors[2], style.high)) {
+    buildLut(style);
+    markAllDirty();
+  }
+  if (values != field.values || min != field.min || max != field.max) {
+    values = field.values;
+    min = field.min;
+    max = field.max;
+    markAllDirty();
+  }
+  int begin = std::max(dirtyBegin, 0);
+  int end = std::min(dirtyEnd, height);
+  dirtyBegin = dirtyEnd = 0;
+  if (begin >= end) {
+    return texture;
+  }
+  SDL_Rect band{0, begin, width, end - begin};
+  void* pixels;
+  int pitch;
+  if (SDL_LockTexture(texture, &band, &pixels, &pitch) != 0) {
+    markDirty(begin, end);
+    return texture;
+  }
+  for (int y = begin; y < end; ++y) {
+    auto dst = reinterpret_cast<Uint32*>(static_cast<Uint8*>(pixels) +
+                                         size_t(y - begin) * pitch);
+    colorRow(values + size_t(y) * width, dst, width);
+  }
+  SDL_UnlockTexture(texture);
+  return texture;
+}
+
+DUI_INLINE void
+HeatmapTexture::buildLut(const HeatmapStyle& style)
+{
+  colors[0] = style.low;
+  colors[1] = style.mid;
+  colors[2] = style.high;
+  for (int i = 0; i < LUT_SIZE; ++i) {
+    // Low to mid on the first half, mid to high on the second
+    int pos = i * 512 / (LUT_SIZE - 1);
+    int half = pos < 256 ? 0 : 1;
+    int t = pos - half * 256;
+    auto& a = colors[half];
+    auto& b = colors[half + 1];
+    auto mix = [t](Uint8 from, Uint8 to) {
+      return Uint8(from + (to - from) * t / 256);
+    };
+    // The texture format has the bytes in SDL_Color order
+    SDL_Color c{mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b), mix(a.a, b.a)};
+    std::memcpy(&lut[i], &c, sizeof(Uint32));
+  }
+}
+
+DUI_INLINE void
+HeatmapTexture::colorRow(const float* src, Uint32* dst, int count) const
+{
+  float scale = max > min ? (LUT_SIZE - 1) / (max - min) : 0.f;
+  float top = float(LUT_SIZE - 1);
+  int indices[BLOCK];
+  for (int start = 0; start < count; start += BLOCK) {
+    int n = std::min(count - start, BLOCK);
+    const float* block = src + start;
+    // Branch free, so it is vectorized. NaN fails both comparisons and gets
+    // the low color
+    for (int i = 0; i < n; ++i) {
+      float x = (block[i] - min) * scale + 0.5f;
+      x = x >= 0.f ? x : 0.f;
+      x = x <= top ? x : top;
+      indices[i] = int(x);
+    }
+    for (int i = 0; i < n; ++i) {
+      dst[start + i] = lut[indices[i]];
+    }
+  }
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_HEATMAP_HPP_
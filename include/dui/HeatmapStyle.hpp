@@ -0,0 +1,77 @@
+#ifndef DUI_HEATMAPSTYLE_HPP_
+#define DUI_HEATMAPSTYLE_HPP_
+
+#include <SDL.h>
+#include "BoxStyle.hpp"
+#include "TextStyle.hpp"
+#include "Theme.hpp"
+
+namespace dui {
+
+// Style for heatmap
+struct HeatmapStyle
+{
+  BoxStyle box;
+  SDL_Color low;  // Color for the field min
+  SDL_Color mid;  // Color halfway
+  SDL_Color high; // Color for the field max
+  TextStyle probe;
+  SDL_Color probeBackground;
+  bool probing; // Show the value under the mouse
+
+  constexpr HeatmapStyle withBox(const BoxStyle& box) const
+  {
+    return {box, low, mid, high, probe, probeBackground, probing};
+  }
+  constexpr HeatmapStyle withLow(SDL_Color low) const
+  {
+    return {box, low, mid, high, probe, probeBackground, probing};
+  }
+  constexpr HeatmapStyle withMid(SDL_Color mid) const
+  {
+    return {box, low, mid, high, probe, probeBackground, probing};
+  }
+  constexpr HeatmapStyle withHigh(SDL_Color high) const
+  {
+    return {box, low, mid, high, probe, probeBackground, probing};
+  }
+  constexpr HeatmapStyle withProbe(const TextStyle& probe) const
+  {
+    return {box, low, mid, high, probe, probeBackground, probing};
+  }
+  constexpr HeatmapStyle withProbeBackground(SDL_Color probeBackground) const
+  {
+    return {box, low, mid, high, probe, probeBackground, probing};
+  }
+  constexpr HeatmapStyle withProbing(bool probing) const
+  {
+    return {box, low, mid, high, probe, probeBackground, probing};
+  }
+};
+
+struct Heatmap;
+
+namespace style {
+
+template<class Theme>
+struct FromTheme<Heatmap, Theme>
+{
+  constexpr static HeatmapStyle get()
+  {
+    auto box = themeFor<Box, Theme>();
+    return {
+      box,
+      {68, 1, 84, 255},
+      {33, 145, 140, 255},
+      {253, 231, 37, 255},
+      themeFor<Text, Theme>(),
+      box.paint.background,
+      true,
+    };
+  }
+};
+} // namespace style
+
+} // namespace dui
+
+#endif // DUI_HEATMAPSTYLE_HPP_
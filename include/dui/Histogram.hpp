@@ -0,0 +1,333 @@
+#ifndef DUI_HISTOGRAM_HPP_
+#define DUI_HISTOGRAM_HPP_
+
+#ifndef DUI_BOUNDED_MEMORY
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <vector>
+#include <SDL.h>
+#include "Box.hpp"
+#include "Group.hpp"
+#include "HistogramStyle.hpp"
+#include "Text.hpp"
+
+namespace dui {
+
+/// How a SampleHistogram bins its samples
+struct HistogramParams
+{
+  float min;     ///< Start of the first bin. If not less than max, the
+                 ///< samples range is used
+  float max;     ///< End of the last bin
+  int bins;      ///< Number of bins
+  bool logScale; ///< If the bins grow exponentially, then min must be > 0
+
+  constexpr bool operator==(const HistogramParams& other) const
+  {
+    return min == other.min && max == other.max && bins == other.bins &&
+           logScale == other.logScale;
+  }
+  constexpr bool operator!=(const HistogramParams& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+/**
+ * @brief The bins of many samples, as shown by histogram()
+ *
+ * The bins are only counted again when the data version or the params change.
+ * Counting is done in blocks, computing all bin indices of a block first, on a
+ * loop the compiler can vectorize, and then adding them to interleaved
+ * counters, so equal consecutive bins do not wait on each other.
+ */
+class SampleHistogram
+{
+  std::vector<Uint32> counts; // Below the first bin, the bins and above last
+  std::vector<Uint32> lanes;  // Interleaved counts, while binning
+  HistogramParams params{0, 0, 0, false};
+  Uint64 version = 0;
+  bool valid = false;
+  float min = 0;
+  float max = 0;
+  size_t total = 0;
+  Uint32 maxCount = 0;
+
+  static constexpr size_t BLOCK = 256;
+  static constexpr size_t LANES = 4;
+
+  void findRange(const float* samples, size_t count);
+  void bin(const float* samples, size_t count);
+
+  // Position of a value, on bins
+  float position(float value) const
+  {
+    if (params.logScale) {
+      return (std::log(value) - std::log(min)) /
+             (std::log(max) - std::log(min)) * params.bins;
+    }
+    return (value - min) / (max - min) * params.bins;
+  }
+
+public:
+  /**
+   * @brief Count the samples on bins, if needed
+   *
+   * @param samples the samples
+   * @param count the number of samples
+   * @param version the samples version, it must change whenever they change
+   * @param params how to bin them
+   * @return true if the bins were counted again
+   */
+  bool update(const float* samples,
+              size_t count,
+              Uint64 version,
+              const HistogramParams& params);
+
+  /// Number of bins
+  int getBinCount() const { return params.bins; }
+
+  /// Number of samples on the given bin
+  Uint32 getBin(int i) const { return counts[i + 1]; }
+
+  /// Number of samples on the fullest bin
+  Uint32 getMaxCount() const { return maxCount; }
+
+  /// Number of samples below the first bin, including NaNs
+  Uint32 getBelow() const { return counts.empty() ? 0 : counts.front(); }
+
+  /// Number of samples above the last bin
+  Uint32 getAbove() const { return counts.empty() ? 0 : counts.back(); }
+
+  /// Number of samples, including the ones out of the bins
+  size_t getTotal() const { return total; }
+
+  /// Start of the first bin
+  float getMin() const { return min; }
+
+  /// End of the last bin
+  float getMax() const { return max; }
+
+  /// If the bins grow exponentially
+  bool isLogScale() const { return params.logScale; }
+
+  /// The value at the given position, in bins from the first bin start
+  float valueAt(float position) const
+  {
+    float t = position / params.bins;
+    if (params.logScale) {
+      return min * std::pow(max / min, t);
+    }
+    return min + (max - min) * t;
+  }
+
+  /**
+   * @brief Estimate a percentile from the bins
+   *
+   * @param fraction the fraction of samples below the result, from 0 to 1
+   * @return float the value, interpolated inside its bin
+   */
+  float percentile(double fraction) const;
+
+  /// The x of a value, on a width covering all bins
+  int xOf(float value, int width) const
+  {
+    return int(position(value) * width / params.bins);
+  }
+};
+
+/**
+ * @brief A histogram, with markers on percentiles
+ * @ingroup elements
+ *
+ * The bars are drawn with at most one box for each pixel column, and all of
+ * them have the same color, so they are filled with few render calls.
+ *
+ * @param target the parent group or frame
+ * @param data the histogram data, updated
+ * @param r the position and size
+ * @param percentiles the fractions to show markers on, from 0 to 1
+ * @param style
+ */
+inline void
+histogram(Target target,
+          const SampleHistogram& data,
+          const SDL_Rect& r,
+          std::initializer_list<double> percentiles = {0.5, 0.9, 0.99},
+          const HistogramStyle& style = themeFor<Histogram>())
+{
+  auto g = group(target, {}, r, Layout::NONE);
+  auto& border = style.box.border;
+  SDL_Rect client{border.left,
+                  border.top,
+                  r.w - border.left - border.right,
+                  r.h - border.top - border.bottom};
+  int bins = data.getBinCount();
+  Uint32 maxCount = data.getMaxCount();
+  if (bins > 0 && maxCount > 0 && client.w > 0) {
+    auto& label = style.label;
+    auto& font = label.font.texture ? label.font : g.getState().getFont();
+    for (auto fraction : percentiles) {
+      int x = client.x + data.xOf(data.percentile(fraction), client.w);
+      char name[16];
+      SDL_snprintf(name, sizeof(name), "p%g", fraction * 100);
+      auto nameSize = measure(name, font, label.scale);
+      int nameX = std::min(x + 2, client.x + client.w - nameSize.x);
+      text(g, name, {nameX, client.y + 1}, label);
+      colorBox(g, {x, client.y, 1, client.h}, style.marker);
+    }
+
+    double top = style.logCounts ? std::log1p(double(maxCount)) : maxCount;
+    auto heightOf = [&](Uint32 count) {
+      double value = style.logCounts ? std::log1p(double(count)) : count;
+      return int(value / top * client.h + 0.5);
+    };
+    auto bar = [&](int x0, int x1, Uint32 count) {
+      int h = heightOf(count);
+      if (h > 0 && x1 > x0) {
+        colorBox(g,
+                 {client.x + x0, client.y + client.h - h, x1 - x0, h},
+                 style.bar);
+      }
+    };
+    if (bins >= client.w) {
+      // The fullest bin of each column
+      for (int x = 0; x < client.w; ++x) {
+        Uint32 count = 0;
+        int last = int(Sint64(x + 1) * bins / client.w);
+        for (int i = int(Sint64(x) * bins / client.w); i < last; ++i) {
+          count = std::max(count, data.getBin(i));
+        }
+        bar(x, x + 1, count);
+      }
+    } else {
+      for (int i = 0; i < bins; ++i) {
+        bar(i * client.w / bins, (i + 1) * client.w / bins, data.getBin(i));
+      }
+    }
+  }
+  box(g, {0, 0, r.w, r.h}, style.box);
+}
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE bool
+SampleHistogram::update(const float* samples,
+                        size_t count,
+                        Uint64 version,
+                        const HistogramParams& params)
+{
+  SDL_assert(params.bins > 0);
+  if (valid && version == this->version && params == this->params) {
+    return false;
+  }
+  this->params = params;
+  this->version = version;
+  valid = true;
+  total = count;
+  if (params.min < params.max) {
+    min = params.min;
+    max = params.max;
+  } else {
+    findRange(samples, count);
+  }
+  bin(samples, count);
+  maxCount = 0;
+  for (int i = 0; i < params.bins; ++i) {
+    maxCount = std::max(maxCount, getBin(i));
+  }
+  return true;
+}
+
+DUI_INLINE void
+SampleHistogram::findRange(const float* samples, size_t count)
+{
+  // Comparisons with NaN are false, so they are skipped
+  float lo = INFINITY;
+  float hi = -INFINITY;
+  float floor = params.logScale ? 0.f : -INFINITY;
+  for (size_t i = 0; i < count; ++i) {
+    float v = samples[i];
+    lo = v > floor && v < lo ? v : lo;
+    hi = v > hi && v < INFINITY ? v : hi;
+  }
+  if (!(lo <= hi)) {
+    lo = params.logScale ? 1.f : 0.f;
+    hi = lo;
+  }
+  min = lo;
+  // The max sample must be inside the last bin
+  max = params.logScale ? std::max(hi * 1.0001f, std::nextafter(lo, INFINITY))
+                        : std::max(std::nextafter(hi, INFINITY), lo + 1e-6f);
+}
+
+DUI_INLINE void
+SampleHistogram::bin(const float* samples, size_t count)
+{
+  int bins = params.bins;
+  bool logScale = params.logScale;
+  float lo = logScale ? std::log(min) : min;
+  float hi = logScale ? std::log(max) : max;
+  float scale = bins / (hi - lo);
+  float top = float(bins + 1);
+  size_t stride = bins + 2;
+  lanes.assign(stride * LANES, 0);
+  float values[BLOCK];
+  int indices[BLOCK];
+  for (size_t start = 0; start < count; start += BLOCK) {
+    size_t n = std::min(count - start, BLOCK);
+    const float* block = samples + start;
+    if (logScale) {
+      for (size_t i = 0; i < n; ++i) {
+        values[i] = std::log(block[i]);
+      }
+      block = values;
+    }
+    // Branch free, so it is vectorized. NaN fails both comparisons and ends
+    // below the first bin
+    for (size_t i = 0; i < n; ++i) {
+      float x = (block[i] - lo) * scale + 1.f;
+      x = x >= 0.f ? x : 0.f;
+      x = x <= top ? x : top;
+      indices[i] = int(x);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      lanes[(i % LANES) * stride + indices[i]]++;
+    }
+  }
+  counts.assign(stride, 0);
+  for (size_t lane = 0; lane < LANES; ++lane) {
+    for (size_t i = 0; i < stride; ++i) {
+      counts[i] += lanes[lane * stride + i];
+    }
+  }
+}
+
+DUI_INLINE float
+SampleHistogram::percentile(double fraction) const
+{
+  if (total == 0) {
+    return min;
+  }
+  double wanted = std::clamp(fraction, 0.0, 1.0) * total;
+  double seen = getBelow();
+  if (wanted <= seen) {
+    return min;
+  }
+  for (int i = 0; i < params.bins; ++i) {
+    double count = getBin(i);
+    if (seen + count >= wanted) {
+      return valueAt(float(i + (wanted - seen) / count));
+    }
+    seen += count;
+  }
+  return max;
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_BOUNDED_MEMORY
+
+#endif // DUI_HISTOGRAM_HPP_
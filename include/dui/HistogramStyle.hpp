@@ -0,0 +1,66 @@
+#ifndef DUI_HISTOGRAMSTYLE_HPP_
+#define DUI_HISTOGRAMSTYLE_HPP_
+
+#include <SDL.h>
+#include "BoxStyle.hpp"
+#include "ButtonStyle.hpp"
+#include "TextStyle.hpp"
+#include "Theme.hpp"
+
+namespace dui {
+
+// Style for histogram
+struct HistogramStyle
+{
+  BoxStyle box;
+  SDL_Color bar;
+  SDL_Color marker;
+  TextStyle label;
+  bool logCounts; // Bar heights on logarithmic scale
+
+  constexpr HistogramStyle withBox(const BoxStyle& box) const
+  {
+    return {box, bar, marker, label, logCounts};
+  }
+  constexpr HistogramStyle withBar(SDL_Color bar) const
+  {
+    return {box, bar, marker, label, logCounts};
+  }
+  constexpr HistogramStyle withMarker(SDL_Color marker) const
+  {
+    return {box, bar, marker, label, logCounts};
+  }
+  constexpr HistogramStyle withLabel(const TextStyle& label) const
+  {
+    return {box, bar, marker, label, logCounts};
+  }
+  constexpr HistogramStyle withLogCounts(bool logCounts) const
+  {
+    return {box, bar, marker, label, logCounts};
+  }
+};
+
+struct Histogram;
+
+namespace style {
+
+template<class Theme>
+struct FromTheme<Histogram, Theme>
+{
+  constexpr static HistogramStyle get()
+  {
+    auto box = themeFor<Box, Theme>();
+    return {
+      box,
+      themeFor<ButtonBase, Theme>().grabbed.background,
+      {192, 48, 48, 255},
+      themeFor<Text, Theme>(),
+      false,
+    };
+  }
+};
+} // namespace style
+
+} // namespace dui
+
+#endif // DUI_HISTOGRAMSTYLE_HPP_
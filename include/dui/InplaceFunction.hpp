@@ -0,0 +1,66 @@
+#ifndef DUI_INPLACEFUNCTION_HPP_
+#define DUI_INPLACEFUNCTION_HPP_
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace dui {
+
+template<class SIGNATURE, size_t SIZE>
+class InplaceFunction;
+
+/**
+ * @brief A std::function like wrapper that never allocates
+ *
+ * The callable is stored inside the object, so it must fit in SIZE bytes.
+ */
+template<class R, class... ARGS, size_t SIZE>
+class InplaceFunction<R(ARGS...), SIZE>
+{
+  alignas(std::max_align_t) unsigned char storage[SIZE];
+  R (*invoker)(const void*, ARGS...);
+  void (*copier)(void*, const void*);
+  void (*destroyer)(void*);
+
+public:
+  /// Ctor
+  template<class FUNC>
+  InplaceFunction(FUNC func)
+  {
+    static_assert(sizeof(FUNC) <= SIZE,
+                  "Callable too big, increase DUI_MAX_INITIALIZER_SIZE");
+    static_assert(alignof(FUNC) <= alignof(std::max_align_t));
+    new (storage) FUNC(std::move(func));
+    invoker = [](const void* f, ARGS... args) -> R {
+      return (*static_cast<const FUNC*>(f))(std::forward<ARGS>(args)...);
+    };
+    copier = [](void* dst, const void* src) {
+      new (dst) FUNC(*static_cast<const FUNC*>(src));
+    };
+    destroyer = [](void* f) { static_cast<FUNC*>(f)->~FUNC(); };
+  }
+
+  /// Copy ctor
+  InplaceFunction(const InplaceFunction& rhs)
+    : invoker(rhs.invoker)
+    , copier(rhs.copier)
+    , destroyer(rhs.destroyer)
+  {
+    copier(storage, rhs.storage);
+  }
+
+  InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+  ~InplaceFunction() { destroyer(storage); }
+
+  /// Invoke the callable
+  R operator()(ARGS... args) const
+  {
+    return invoker(storage, std::forward<ARGS>(args)...);
+  }
+};
+
+} // namespace dui
+
+#endif // DUI_INPLACEFUNCTION_HPP_
@@ -59,16 +59,19 @@ textBoxBase(Target target,
             SDL_Rect r,
             const InputBoxStyle& style = themeFor<InputBoxBase>())
 {
-  static size_t cursorPos = 0;
-  static size_t maxPos = 0;
   r = makeInputRect(r, style);
-  if (target.checkMouse(id, r) == MouseAction::GRAB) {
-    maxPos = cursorPos = value.size();
-  }
+  bool clicked = target.checkMouse(id, r) == MouseAction::GRAB;
 
   auto action = target.checkText(id);
   bool active = action == TextAction::NONE ? target.isActive(id) : true;
-  if (active && cursorPos > value.size()) {
+  // Only the active box edits, so the others do not touch the state
+  size_t inactiveCursor = 0;
+  size_t inactiveMax = 0;
+  auto& cursorPos =
+    active ? target.getState().getTextEdit().cursor : inactiveCursor;
+  auto& maxPos =
+    active ? target.getState().getTextEdit().maxCursor : inactiveMax;
+  if (active && (clicked || cursorPos > value.size())) {
     maxPos = cursorPos = value.size();
   }
   auto& currentColors = active ? style.active : style.normal;
@@ -92,7 +95,11 @@ textBoxBase(Target target,
   }
   text(g, value, {-deltaX, 0}, {style.font, currentColors.text, style.scale});
 
-  if (active && (target.getState().ticks() / 512) % 2) {
+  auto& state = target.getState();
+  if (active && state.isAnimating()) {
+    state.scheduleUpdate((state.ticks() / 512 + 1) * 512);
+  }
+  if (active && (!state.isAnimating() || (state.ticks() / 512) % 2)) {
     // Show cursor
     colorBox(
       g, {int(cursorPos) * 8 - deltaX, 0, 1, clientSz.y}, currentColors.text);
@@ -199,7 +206,7 @@ class BufferedInputBox
 public:
   /// Amount to increment the backing value by
   int incAmount = 0;
-  static constexpr int BUF_SZ = 256; ///< Buffer size
+  static constexpr int BUF_SZ = TextEdit::BUFFER_SIZE; ///< Buffer size
   char buffer[BUF_SZ];               ///< Buffer
 
   /// Ctor
@@ -242,7 +249,7 @@ public:
       textBox(target, id, buffer, BUF_SZ, rect, style);
       return false;
     }
-    static char editBuffer[BUF_SZ];
+    auto editBuffer = target.getState().getTextEdit().buffer;
     if (refillBuffer) {
       SDL_strlcpy(editBuffer, buffer, BUF_SZ);
     }
@@ -0,0 +1,106 @@
+#ifndef DUI_JOB_HPP_
+#define DUI_JOB_HPP_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <SDL.h>
+
+namespace dui {
+
+class State;
+
+/**
+ * @brief Progress and cancellation of a background job
+ *
+ * It is shared by the ui thread and the worker running the job. The job
+ * function receives it to report progress and to check if it should give up.
+ * @see State.job()
+ */
+class JobControl
+{
+  std::atomic<float> progress{0};
+  std::atomic<bool> cancelled{false};
+  bool done = false; // Only touched on the ui thread
+
+  friend class State;
+
+public:
+  virtual ~JobControl() = default;
+
+  /// Report the progress, from 0 to 1. Called from the job
+  void setProgress(float value)
+  {
+    progress.store(value, std::memory_order_relaxed);
+  }
+
+  /// The last reported progress, from 0 to 1
+  float getProgress() const
+  {
+    return done ? 1.f : progress.load(std::memory_order_relaxed);
+  }
+
+  /// Ask the job to stop. It is up to the job to check isCancelled()
+  void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+
+  /// If the job should stop as soon as possible
+  bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+  /// If the result is available. Only valid on the ui thread
+  bool isDone() const { return done; }
+};
+
+/// A job control with the job result
+template<class T>
+struct JobResult : JobControl
+{
+  std::optional<T> value; ///< Set by the worker before the job is done
+};
+
+/**
+ * @brief Handle to a background job, as returned by State.job()
+ *
+ * It changes from pending to done only at the beginning of a frame, so it is
+ * consistent during the whole frame.
+ */
+template<class T>
+class Job
+{
+  std::shared_ptr<JobResult<T>> data;
+
+public:
+  /// Ctor
+  Job(std::shared_ptr<JobResult<T>> data)
+    : data(std::move(data))
+  {}
+
+  /// If the result is available
+  bool isDone() const { return data->isDone(); }
+
+  /// The progress, from 0 to 1
+  float getProgress() const { return data->getProgress(); }
+
+  /// The result if done, nullptr otherwise
+  T* get() const { return isDone() ? &*data->value : nullptr; }
+
+  /// Same as isDone()
+  explicit operator bool() const { return isDone(); }
+};
+
+/**
+ * @brief A job on State
+ *
+ */
+struct JobEntry
+{
+  std::string key;                      ///< The owner qualified id
+  std::shared_ptr<JobControl> control;  ///< The job control
+  std::function<void(State&)> schedule; ///< Starts the job if not empty
+  Uint32 lastFrame;                     ///< Last frame it was asked for
+};
+
+} // namespace dui
+
+#endif // DUI_JOB_HPP_
@@ -0,0 +1,58 @@
+#ifndef DUI_JOBBOX_HPP_
+#define DUI_JOBBOX_HPP_
+
+#ifndef DUI_BOUNDED_MEMORY
+
+#include <string_view>
+#include "Job.hpp"
+#include "ProgressBar.hpp"
+#include "State.hpp"
+#include "Target.hpp"
+
+namespace dui {
+
+/**
+ * @brief A placeholder showing the progress of a job until it is done
+ * @ingroup elements
+ *
+ * It starts the job on the first call and shows a progress bar on r while it
+ * runs. Once it is done nothing is shown, and the result can be used to build
+ * the actual content:
+ *
+ * ```
+ * auto image = dui::jobBox(g, "image", [&](dui::JobControl& c) {
+ *   return loadPixels(path, c);
+ * }, {0, 0, 256, 16});
+ * if (auto pixels = image.get()) { ... }
+ * ```
+ *
+ * If the placeholder is not built on a frame, the job is cancelled.
+ * @see State.job()
+ *
+ * @param target the parent group or frame
+ * @param id the job id
+ * @param work a callable with the signature T(JobControl&)
+ * @param r the placeholder local position and size
+ * @param style
+ * @return Job<T> the job handle
+ */
+template<class FUNC>
+inline auto
+jobBox(Target target,
+       std::string_view id,
+       FUNC work,
+       const SDL_Rect& r,
+       const ProgressBarStyle& style = themeFor<ProgressBar>())
+{
+  auto job = target.getState().job(id, std::move(work));
+  if (!job) {
+    progressBar(target, job.getProgress(), r, style);
+  }
+  return job;
+}
+
+} // namespace dui
+
+#endif // DUI_BOUNDED_MEMORY
+
+#endif // DUI_JOBBOX_HPP_
@@ -1,6 +1,7 @@
 #ifndef DUI_LABEL_HPP_
 #define DUI_LABEL_HPP_
 
+#include <algorithm>
 #include <string_view>
 #include "EdgeSize.hpp"
 #include "Element.hpp"
@@ -27,6 +28,46 @@ label(Target target,
 {
   element(target, str, {p.x, p.y, 0, 0}, style);
 }
+
+/// @copydoc label()
+/// @ingroup elements
+/// With no visible box on the style, only the text is added.
+template<class SOURCE>
+inline void
+label(Target target,
+      std::string_view str,
+      const SDL_Point& p,
+      StaticStyle<SOURCE> style)
+{
+  element(target, str, {p.x, p.y, 0, 0}, style);
+}
+/// @copydoc label()
+/// @ingroup elements
+template<class SOURCE>
+inline void
+label(Target target, std::string_view str, StaticStyle<SOURCE> style)
+{
+  label(target, str, {0}, style);
+}
+
+/**
+ * @brief A label formatted from the given arguments
+ * @ingroup elements
+ *
+ * The text is formatted on State memory, with no allocations once it is warm.
+ * For other positions and styles, use label() with State.format().
+ *
+ * @param target the parent group or frame
+ * @param fmt the format, with a "{}" for each argument
+ * @param args the arguments
+ */
+template<class... ARGS>
+inline void
+labelf(Target target, std::string_view fmt, const ARGS&... args)
+{
+  label(target, target.getState().format(fmt, args...));
+}
+
 /**
  * @brief A centered label
  * @ingroup elements
@@ -59,6 +100,75 @@ centeredLabel(Target target,
        style);
   box(target, r, style);
 }
+
+/**
+ * @brief A label broken into lines that fit its width
+ * @ingroup elements
+ *
+ * @param target the parent group or frame
+ * @param str the text to show
+ * @param r the local relative rect to add the label. If w is 0, the label
+ * takes the target width after r.x and if h is 0, the height of its lines. If
+ * there is no width, it is a plain label().
+ * @param style
+ */
+inline void
+wrappedLabel(Target target,
+             std::string_view str,
+             const SDL_Rect& r = {0},
+             const ElementStyle& style = themeFor<Label>())
+{
+  auto offset = style.padding + style.border;
+  int w = r.w != 0 ? r.w : target.width() - r.x;
+  int clientW = w - offset.left - offset.right;
+  if (clientW <= 0) {
+    element(target, str, r, style);
+    return;
+  }
+  auto& state = target.getState();
+  auto& font = style.font.texture ? style.font : state.getFont();
+  auto charSize = measure('X', font, style.scale);
+  int h = r.h;
+  if (h == 0) {
+    int lines = 0;
+    size_t columns = std::max(clientW / charSize.x, 1);
+    state.forEachLine(str, columns, [&](TextLine) { lines++; });
+    h = elementSize(offset, {clientW, std::max(lines, 1) * charSize.y}).y;
+  }
+  auto g = group(target, {}, {r.x, r.y, w, h}, Layout::NONE);
+  wrappedText(g, str, {offset.left, offset.top}, clientW, style);
+  box(g, {0, 0, w, h}, style);
+}
+
+/**
+ * @brief A label cut to fit its width, ending in "..."
+ * @ingroup elements
+ *
+ * @param target the parent group or frame
+ * @param str the text to show
+ * @param r the local relative rect to add the label. If w is 0, the label
+ * takes the target width after r.x. If there is no width, it is a plain
+ * label().
+ * @param style
+ */
+inline void
+ellipsizedLabel(Target target,
+                std::string_view str,
+                const SDL_Rect& r = {0},
+                const ElementStyle& style = themeFor<Label>())
+{
+  auto offset = style.padding + style.border;
+  int w = r.w != 0 ? r.w : target.width() - r.x;
+  int clientW = w - offset.left - offset.right;
+  if (clientW <= 0) {
+    element(target, str, r, style);
+    return;
+  }
+  int h = r.h != 0 ? r.h : computeSize(str, style, {w, 0}).y;
+  auto g = group(target, {}, {r.x, r.y, w, h}, Layout::NONE);
+  ellipsizedText(g, str, {offset.left, offset.top}, clientW, style);
+  box(g, {0, 0, w, h}, style);
+}
 } // namespace dui
 
 #endif // DUI_LABEL_HPP_
@@ -0,0 +1,95 @@
+#ifndef DUI_LATENCYHISTOGRAM_HPP_
+#define DUI_LATENCYHISTOGRAM_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <SDL.h>
+#include "Config.hpp"
+
+namespace dui {
+
+/**
+ * @brief The kinds of input whose latency is measured
+ * @see State.getLatency()
+ */
+enum class InputKind
+{
+  MOUSE_MOTION, ///< SDL_MOUSEMOTION and SDL_MOUSEWHEEL
+  MOUSE_BUTTON, ///< SDL_MOUSEBUTTONDOWN and SDL_MOUSEBUTTONUP
+  TEXT,         ///< SDL_TEXTINPUT
+  KEY,          ///< SDL_KEYDOWN
+  COUNT,        ///< Number of kinds, not a kind itself
+};
+
+/**
+ * @brief Distribution of latencies, in microseconds
+ *
+ * The values are counted in fixed buckets of BUCKET_SIZE, so percentiles have
+ * this precision. Values over the last bucket are counted on it.
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr int BUCKETS = 512;
+  static constexpr Uint32 BUCKET_SIZE = 500; ///< In microseconds
+
+  /// Count a latency
+  void add(Uint32 us)
+  {
+    buckets[std::min(us / BUCKET_SIZE, Uint32(BUCKETS - 1))]++;
+    total++;
+    maxValue = std::max(maxValue, us);
+  }
+
+  /// Number of latencies counted
+  Uint32 count() const { return total; }
+
+  /// Largest latency counted
+  Uint32 max() const { return maxValue; }
+
+  /**
+   * @brief The latency that p percent of the counted ones do not exceed
+   *
+   * @param p the percentile, from 0 to 100, 50 is the median
+   * @return Uint32 the upper bound of the bucket where it falls, or max() if
+   * that is lower.
+   */
+  Uint32 percentile(double p) const;
+
+  /// Forget all counted latencies
+  void clear()
+  {
+    std::fill(std::begin(buckets), std::end(buckets), 0);
+    total = 0;
+    maxValue = 0;
+  }
+
+private:
+  Uint32 buckets[BUCKETS] = {0};
+  Uint32 total = 0;
+  Uint32 maxValue = 0;
+};
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE Uint32
+LatencyHistogram::percentile(double p) const
+{
+  if (total == 0) {
+    return 0;
+  }
+  auto rank = std::max(Uint32(std::ceil(p * total / 100)), Uint32(1));
+  Uint32 accumulated = 0;
+  for (int i = 0; i < BUCKETS - 1; ++i) {
+    accumulated += buckets[i];
+    if (accumulated >= rank) {
+      return std::min((i + 1) * BUCKET_SIZE, maxValue);
+    }
+  }
+  return maxValue;
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_LATENCYHISTOGRAM_HPP_
@@ -41,6 +41,13 @@ class LayerImpl : public Targetable<LayerImpl>
   SDL_Point topLeft;
   SDL_Point bottomRight;
 
+  // The rect is on screen, so undo the parent caret added by lock and unlock
+  SDL_Rect parentRect() const
+  {
+    auto caret = parent.getCaret();
+    return {rect.x - caret.x, rect.y - caret.y, rect.w, rect.h};
+  }
+
 public:
   LayerImpl(Target parent, std::string_view id, const SDL_Rect& rect)
     : guard(parent.getState())
@@ -50,7 +57,7 @@ public:
     , topLeft({rect.x, rect.y})
     , bottomRight({rect.x + rect.w, rect.y + rect.h})
   {
-    parent.lock(id, rect);
+    parent.lock(id, parentRect());
   }
 
   LayerImpl(const LayerImpl&) = delete;
@@ -83,7 +90,7 @@ public:
     if (rect.h == 0) {
       rect.h = height();
     }
-    parent.unlock(id, rect);
+    parent.unlock(id, parentRect());
     ended = true;
     parent = {};
     guard.reset();
@@ -105,6 +112,16 @@ public:
   }
 };
 
+/**
+ * @brief Adds a layer, shown over everything not on a layer above it
+ * @ingroup groups
+ *
+ * @param target the parent group or frame
+ * @param id the layer id
+ * @param r the layer position and size, on screen coordinates. If the size is
+ * 0, it is the size of its content
+ * @return LayerImpl
+ */
 inline LayerImpl
 layer(Target target, std::string_view id, const SDL_Rect& r)
 {
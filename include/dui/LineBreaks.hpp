@@ -0,0 +1,70 @@
+#ifndef DUI_LINEBREAKS_HPP_
+#define DUI_LINEBREAKS_HPP_
+
+#include <string_view>
+
+namespace dui {
+
+/// A line of wrapped text, as offsets on the text
+struct TextLine
+{
+  size_t begin; ///< First character
+  size_t end;   ///< After the last character, trailing spaces excluded
+  size_t next;  ///< Where the next line begins
+};
+
+/**
+ * @brief Find the line beginning at start
+ *
+ * Lines break on new lines and, when longer than the given columns, on the
+ * last space that fits. Words longer than a line are split. The spaces around
+ * a soft break are left out.
+ *
+ * @param str the text
+ * @param start where the line begins
+ * @param columns the characters that fit on a line, at least 1
+ * @return TextLine
+ */
+constexpr TextLine
+nextLine(std::string_view str, size_t start, size_t columns)
+{
+  auto trimmed = [&](size_t end) {
+    while (end > start && str[end - 1] == ' ') {
+      end--;
+    }
+    return end;
+  };
+  size_t limit = str.size() - start > columns ? start + columns : str.size();
+  for (size_t i = start; i < limit; ++i) {
+    if (str[i] == '\n') {
+      return {start, trimmed(i), i + 1};
+    }
+  }
+  if (limit == str.size()) {
+    return {start, trimmed(limit), limit};
+  }
+  size_t end = limit;
+  if (str[limit] != ' ' && str[limit] != '\n') {
+    // Back to the last space, unless the word fills the line
+    size_t space = limit;
+    while (space > start && str[space - 1] != ' ') {
+      space--;
+    }
+    if (space > start && trimmed(space) > start) {
+      end = space - 1;
+    }
+  }
+  size_t next = end;
+  while (next < str.size() && str[next] == ' ') {
+    next++;
+  }
+  if (next < str.size() && str[next] == '\n') {
+    // The soft break is already a line break
+    next++;
+  }
+  return {start, trimmed(end), next};
+}
+
+} // namespace dui
+
+#endif // DUI_LINEBREAKS_HPP_
@@ -0,0 +1,175 @@
+#ifndef DUI_MEMO_HPP_
+#define DUI_MEMO_HPP_
+
+#include <functional>
+#include <string_view>
+#include "Group.hpp"
+#include "State.hpp"
+
+namespace dui {
+
+/// Hash a memo() dependency
+template<class T>
+inline size_t
+memoHash(const T& value)
+{
+  return std::hash<T>{}(value);
+}
+
+/// Hash a memo() dependency string by its content
+inline size_t
+memoHash(std::string_view value)
+{
+  return std::hash<std::string_view>{}(value);
+}
+
+/// Hash a memo() dependency string by its content
+inline size_t
+memoHash(const char* value)
+{
+  return memoHash(std::string_view{value});
+}
+
+/// Combine the hashes of all given dependencies
+template<class... DEPS>
+inline size_t
+memoHashAll(const DEPS&... deps)
+{
+  size_t seed = 0;
+  ((seed ^= memoHash(deps) + 0x9e3779b9 + (seed << 6) + (seed >> 2)), ...);
+  return seed;
+}
+
+/// A memoized group @see memo()
+class MemoImpl : public Targetable<MemoImpl>
+{
+  Group client;
+  MemoEntry* entry;
+  size_t depsHash;
+  SDL_Point origin;
+  size_t start;
+  int layerCount;
+  int dropped;
+
+  bool isReplayable(const State& state) const
+  {
+    // Over the frame budget, changes might wait a few frames
+    auto age = state.getFrameCount() - entry->builtFrame;
+    if (entry->depsHash != depsHash &&
+        age >= Uint32(state.getGovernor().memoInterval)) {
+      return false;
+    }
+    return !state.hasGroupInput(
+             {origin.x, origin.y, entry->rect.w, entry->rect.h}) &&
+           !state.isGroupAnimating();
+  }
+
+public:
+  /// Ctor
+  MemoImpl(Target parent, std::string_view id, size_t depsHash);
+
+  MemoImpl(const MemoImpl&) = delete;
+  MemoImpl& operator=(const MemoImpl&) = delete;
+
+  ~MemoImpl()
+  {
+    if (client) {
+      end();
+    }
+  }
+
+  /// Finishes the group, recording its content
+  void end();
+
+  /// Returns a target object to this
+  operator Target() & { return client; }
+
+  /// Returns true if the content must be built
+  operator bool() const { return client; }
+};
+
+/**
+ * @brief Adds a memoized group
+ * @ingroup groups
+ *
+ * If the dependencies are the same than last frame, none of its elements
+ * has received input, mouse wheel included, and none of its animations is
+ * running, the content recorded on the last frame is added again and the
+ * returned group is already ended. Otherwise it behaves like a
+ * group() and its content is recorded when it ends:
+ *
+ * ```
+ * if (auto m = dui::memo(f, "stats", count, name)) {
+ *   dui::label(m, name);
+ *   ...
+ * }
+ * ```
+ *
+ * So the content must be a function of the dependencies only. Each dependency
+ * must be hashable by std::hash, and strings are hashed by their content. The
+ * width given to the parent is a dependency too, so content fitted to it is
+ * built again when the parent is resized. The content is never cached if it
+ * adds layers or if DUI_BOUNDED_MEMORY is defined. If over the frame budget,
+ * the old content might still be replayed for a few frames after the
+ * dependencies change (@see State.setFrameBudget()).
+ *
+ * @param target the parent group or frame
+ * @param id the group id
+ * @param deps the values the content depends on
+ * @return MemoImpl
+ */
+template<class... DEPS>
+inline MemoImpl
+memo(Target target, std::string_view id, const DEPS&... deps)
+{
+  return {target, id, memoHashAll(target.getRect().w, deps...)};
+}
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE MemoImpl::MemoImpl(Target parent,
+                          std::string_view id,
+                          size_t depsHash)
+  : client(group(parent, id))
+  , depsHash(depsHash)
+{
+  auto& state = parent.getState();
+  origin = Target(client).getCaret();
+  entry = state.getMemo();
+  if (entry && entry->valid && isReplayable(state)) {
+    state.getDisplayList().replay(
+      entry->recording,
+      {origin.x - entry->rect.x, origin.y - entry->rect.y});
+    state.touchGroup();
+    client.setWidth(entry->rect.w);
+    client.setHeight(entry->rect.h);
+    client.end();
+    return;
+  }
+  start = state.getDisplayList().mark();
+  layerCount = state.getLayerCount();
+  dropped = state.getDisplayList().getDropped();
+}
+
+DUI_INLINE void
+MemoImpl::end()
+{
+  SDL_assert(client);
+  if (entry) {
+    auto& state = client.getState();
+    auto& dList = state.getDisplayList();
+    entry->valid = state.getLayerCount() == layerCount &&
+                   dList.getDropped() == dropped;
+    if (entry->valid) {
+      dList.record(start, entry->recording);
+      entry->depsHash = depsHash;
+      entry->builtFrame = state.getFrameCount();
+      entry->rect = {origin.x, origin.y, client.width(), client.height()};
+    }
+  }
+  client.end();
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_MEMO_HPP_
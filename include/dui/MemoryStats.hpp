@@ -0,0 +1,22 @@
+#ifndef DUI_MEMORYSTATS_HPP_
+#define DUI_MEMORYSTATS_HPP_
+
+#include <cstddef>
+
+namespace dui {
+
+/**
+ * @brief Memory footprint of the ui buffers
+ *
+ * @see State.getMemoryStats()
+ */
+struct MemoryStats
+{
+  size_t reserved;      ///< Bytes currently allocated by the buffers
+  size_t used;          ///< Bytes in use by the last frame
+  size_t highWaterMark; ///< Bytes needed by the busiest recent frame
+};
+
+} // namespace dui
+
+#endif // DUI_MEMORYSTATS_HPP_
@@ -0,0 +1,544 @@
+#ifndef DUI_NODEEDITOR_HPP_
+#define DUI_NODEEDITOR_HPP_
+
+#ifndef DUI_BOUNDED_MEMORY
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <SDL.h>
+#include "Box.hpp"
+#include "Element.hpp"
+#include "Geometry.hpp"
+#include "Group.hpp"
+#include "NodeEditorStyle.hpp"
+#include "State.hpp"
+
+namespace dui {
+
+/// A node of a NodeGraph
+struct GraphNode
+{
+  std::string title; ///< Shown on it
+  SDL_Rect rect;     ///< Position and size on the graph, at least 1x1
+  int inputs;        ///< Number of input ports, on its left side
+  int outputs;       ///< Number of output ports, on its right side
+};
+
+/// A link from an output port to an input port of a NodeGraph
+struct GraphLink
+{
+  Uint32 from; ///< The node with the output
+  int output;  ///< The output port
+  Uint32 to;   ///< The node with the input
+  int input;   ///< The input port
+};
+
+/**
+ * @brief Nodes and the links between them, as shown by nodeEditor()
+ *
+ * The nodes and links are kept on a grid of square cells, so finding the ones
+ * on an area only looks at the cells it touches, no matter the graph size.
+ */
+class NodeGraph
+{
+  struct Cell
+  {
+    std::vector<Uint32> nodes;
+    std::vector<Uint32> links;
+  };
+
+  std::vector<GraphNode> nodes;
+  std::vector<GraphLink> links;
+  std::vector<std::vector<Uint32>> nodeLinks; // The links of each node
+  std::unordered_map<Uint64, Cell> cells;
+  std::vector<Uint32> longLinks; // Too long to be on cells, always checked
+
+  // Last query that found each node and link, so each is found only once
+  std::vector<Uint32> nodeQueries;
+  std::vector<Uint32> linkQueries;
+  Uint32 queryCount = 0;
+
+  static constexpr int CELL_SIZE = 256;
+  static constexpr int MAX_LINK_CELLS = 64;
+
+  static int cellOf(int v)
+  {
+    return v >= 0 ? v / CELL_SIZE : (v - CELL_SIZE + 1) / CELL_SIZE;
+  }
+
+  static Uint64 cellKey(int x, int y)
+  {
+    return Uint64(Uint32(x)) << 32 | Uint32(y);
+  }
+
+  // The cells touched by r, as an inclusive range
+  static SDL_Rect cellRange(const SDL_Rect& r)
+  {
+    int x0 = cellOf(r.x);
+    int y0 = cellOf(r.y);
+    return {x0, y0, cellOf(r.x + r.w - 1) - x0, cellOf(r.y + r.h - 1) - y0};
+  }
+
+  void placeNode(Uint32 i, bool insert);
+  void placeLink(Uint32 i, bool insert);
+
+public:
+  /// No node
+  static constexpr Uint32 NONE = Uint32(-1);
+
+  /// Add a node, returning its index
+  Uint32 addNode(GraphNode node);
+
+  /// Add a link between existing nodes, returning its index
+  Uint32 addLink(const GraphLink& link);
+
+  /// Move a node to the given graph position, its links follow it
+  void moveNode(Uint32 i, const SDL_Point& pos);
+
+  /// The nodes, in the order they were added
+  const std::vector<GraphNode>& getNodes() const { return nodes; }
+
+  /// The links, in the order they were added
+  const std::vector<GraphLink>& getLinks() const { return links; }
+
+  /// Position of an input port
+  SDL_Point inputPos(Uint32 node, int input) const
+  {
+    auto& r = nodes[node].rect;
+    return {r.x, r.y + r.h * (input + 1) / (nodes[node].inputs + 1)};
+  }
+
+  /// Position of an output port
+  SDL_Point outputPos(Uint32 node, int output) const
+  {
+    auto& r = nodes[node].rect;
+    return {r.x + r.w, r.y + r.h * (output + 1) / (nodes[node].outputs + 1)};
+  }
+
+  /**
+   * @brief The control points of the bezier curve drawn for a link
+   *
+   * @param link the link
+   * @param points receives the 4 points
+   */
+  void linkCurve(const GraphLink& link, SDL_Point* points) const
+  {
+    auto from = outputPos(link.from, link.output);
+    auto to = inputPos(link.to, link.input);
+    int d = std::max(std::abs(to.x - from.x) / 2, 32);
+    points[0] = from;
+    points[1] = {from.x + d, from.y};
+    points[2] = {to.x - d, to.y};
+    points[3] = to;
+  }
+
+  /// Bounds of a link curve
+  SDL_Rect linkBounds(const GraphLink& link) const
+  {
+    SDL_Point p[4];
+    linkCurve(link, p);
+    int x0 = std::min({p[0].x, p[1].x, p[2].x, p[3].x});
+    int y0 = std::min({p[0].y, p[1].y, p[2].y, p[3].y});
+    int x1 = std::max({p[0].x, p[1].x, p[2].x, p[3].x});
+    int y1 = std::max({p[0].y, p[1].y, p[2].y, p[3].y});
+    return {x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+  }
+
+  /**
+   * @brief Find the nodes and links on an area
+   *
+   * @param area the area, on graph coordinates
+   * @param foundNodes if not null, receives the indices of nodes touching it
+   * @param foundLinks if not null, receives the indices of links whose
+   * bounds touch it
+   */
+  void query(const SDL_Rect& area,
+             std::vector<Uint32>* foundNodes,
+             std::vector<Uint32>* foundLinks);
+
+  /// The last added node containing the given graph position, or NONE
+  Uint32 nodeAt(const SDL_Point& p) const;
+};
+
+/// The view and selection of a nodeEditor()
+struct NodeEditorState
+{
+  SDL_Point offset{0, 0};           ///< Graph position at top left corner
+  float zoom = 1.f;                 ///< Screen pixels per graph unit
+  Uint32 selected = NodeGraph::NONE; ///< The selected node
+
+  // Used by nodeEditor() between frames
+  Uint32 dragged = NodeGraph::NONE;
+  SDL_Point grabbed{0, 0};
+  std::vector<Uint32> visibleNodes;
+  std::vector<Uint32> visibleLinks;
+
+  static constexpr float MIN_ZOOM = 1.f / 32;
+  static constexpr float MAX_ZOOM = 4.f;
+  static constexpr float ZOOM_STEP = 1.25f; ///< Per mouse wheel step
+
+  /// Convert from graph to screen coordinates, relative to the editor
+  SDL_Point toScreen(const SDL_Point& p) const
+  {
+    return {int(std::floor((p.x - offset.x) * zoom)),
+            int(std::floor((p.y - offset.y) * zoom))};
+  }
+
+  /// Convert from screen coordinates, relative to the editor, to graph
+  SDL_Point toGraph(const SDL_Point& p) const
+  {
+    return {offset.x + int(std::floor(p.x / zoom)),
+            offset.y + int(std::floor(p.y / zoom))};
+  }
+};
+
+/**
+ * @brief A pannable and zoomable view of a NodeGraph
+ * @ingroup elements
+ *
+ * Dragging a node moves it, dragging the background pans the view, and the
+ * mouse wheel zooms around the mouse. Only the nodes and links touching the
+ * view are looked at, so graphs with thousands of nodes cost about the same
+ * as the part shown. Links are drawn as polylines, with fewer segments the
+ * shorter they are on screen, and zoomed out nodes are drawn as plain boxes.
+ *
+ * @param target the parent group or frame
+ * @param id the editor id
+ * @param graph the graph
+ * @param editor the editor state, it must be kept between frames
+ * @param r the editor position and size
+ * @param style
+ * @return true if a node was moved or selected on this frame
+ */
+inline bool
+nodeEditor(Target target,
+           std::string_view id,
+           NodeGraph* graph,
+           NodeEditorState* editor,
+           const SDL_Rect& r,
+           const NodeEditorStyle& style = themeFor<NodeEditor>())
+{
+  SDL_assert(graph != nullptr && editor != nullptr);
+  bool changed = false;
+  auto g = group(target, id, r, Layout::NONE);
+  Target canvas = g;
+  SDL_Rect client{0, 0, r.w, r.h};
+  auto mouse = canvas.lastMousePos();
+  auto& nodes = graph->getNodes();
+
+  auto action = canvas.checkMouse("canvas", client);
+  if (action == MouseAction::GRAB) {
+    auto pos = editor->toGraph(mouse);
+    auto hit = editor->selected;
+    if (hit >= nodes.size() || !SDL_PointInRect(&pos, &nodes[hit].rect)) {
+      hit = graph->nodeAt(pos);
+    }
+    changed = hit != editor->selected;
+    editor->selected = editor->dragged = hit;
+    if (hit != NodeGraph::NONE) {
+      auto& rect = nodes[hit].rect;
+      editor->grabbed = {pos.x - rect.x, pos.y - rect.y};
+    } else {
+      editor->grabbed = pos;
+    }
+  } else if (action == MouseAction::HOLD || action == MouseAction::DRAG) {
+    auto pos = editor->toGraph(mouse);
+    if (editor->dragged < nodes.size()) {
+      auto& rect = nodes[editor->dragged].rect;
+      SDL_Point moved{pos.x - editor->grabbed.x, pos.y - editor->grabbed.y};
+      if (moved.x != rect.x || moved.y != rect.y) {
+        graph->moveNode(editor->dragged, moved);
+        changed = true;
+      }
+    } else {
+      // Keep the grabbed graph position under the mouse
+      auto offset = editor->toGraph(mouse);
+      editor->offset.x += editor->grabbed.x - offset.x;
+      editor->offset.y += editor->grabbed.y - offset.y;
+    }
+  } else if (action != MouseAction::NONE) {
+    editor->dragged = NodeGraph::NONE;
+  }
+  auto wheel = canvas.getState().lastWheel();
+  if (wheel.y != 0 && canvas.isHovered(client)) {
+    // Zoom around the mouse
+    auto pos = editor->toGraph(mouse);
+    float zoom = editor->zoom * std::pow(editor->ZOOM_STEP, float(wheel.y));
+    editor->zoom = std::clamp(zoom, editor->MIN_ZOOM, editor->MAX_ZOOM);
+    auto moved = editor->toGraph(mouse);
+    editor->offset.x += pos.x - moved.x;
+    editor->offset.y += pos.y - moved.y;
+  }
+
+  float zoom = editor->zoom;
+  SDL_Rect area{editor->offset.x,
+                editor->offset.y,
+                int(std::ceil(r.w / zoom)) + 1,
+                int(std::ceil(r.h / zoom)) + 1};
+  auto& visibleNodes = editor->visibleNodes;
+  auto& visibleLinks = editor->visibleLinks;
+  graph->query(area, &visibleNodes, &visibleLinks);
+
+  // The first added is on top, so the selected, then the last added
+  auto selected = editor->selected;
+  std::sort(visibleNodes.begin(), visibleNodes.end(), [=](Uint32 a, Uint32 b) {
+    return (a == selected) != (b == selected) ? a == selected : a > b;
+  });
+  bool detailed = zoom >= 0.5f;
+  int portSize = std::max(int(style.portSize * zoom), 2);
+  for (auto i : visibleNodes) {
+    auto& node = nodes[i];
+    auto topLeft = editor->toScreen({node.rect.x, node.rect.y});
+    SDL_Rect rect{topLeft.x,
+                  topLeft.y,
+                  std::max(int(node.rect.w * zoom), 1),
+                  std::max(int(node.rect.h * zoom), 1)};
+    auto& nodeStyle = i == editor->selected ? style.selected : style.node;
+    if (!detailed) {
+      colorBox(canvas, rect, nodeStyle.paint.background);
+      continue;
+    }
+    for (int j = 0; j < node.inputs; ++j) {
+      auto p = editor->toScreen(graph->inputPos(i, j));
+      colorBox(canvas,
+               {p.x - portSize / 2, p.y - portSize / 2, portSize, portSize},
+               style.port);
+    }
+    for (int j = 0; j < node.outputs; ++j) {
+      auto p = editor->toScreen(graph->outputPos(i, j));
+      colorBox(canvas,
+               {p.x - portSize / 2, p.y - portSize / 2, portSize, portSize},
+               style.port);
+    }
+    element(canvas, node.title, rect, nodeStyle);
+  }
+
+  // Links go under the nodes. Where the triangles are batched they are drawn
+  // as geometry, so all of them take a single call instead of one each
+  constexpr int MAX_SEGMENTS = 16;
+  SDL_Point points[MAX_SEGMENTS + 1];
+  for (auto i : visibleLinks) {
+    SDL_Point curve[4];
+    graph->linkCurve(graph->getLinks()[i], curve);
+    float x[4], y[4];
+    for (int j = 0; j < 4; ++j) {
+      auto p = editor->toScreen(curve[j]);
+      x[j] = float(p.x);
+      y[j] = float(p.y);
+    }
+    float length = std::abs(x[3] - x[0]) + std::abs(y[3] - y[0]);
+    int segments = std::clamp(int(length / 24), 1, MAX_SEGMENTS);
+    for (int j = 0; j <= segments; ++j) {
+      float t = float(j) / segments;
+      float u = 1 - t;
+      float a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+      points[j] = {int(a * x[0] + b * x[1] + c * x[2] + d * x[3]),
+                   int(a * y[0] + b * y[1] + c * y[2] + d * y[3])};
+    }
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    strokePolyline(canvas, points, segments + 1, style.link, 1.f);
+#else
+    polyline(canvas, points, segments + 1, style.link);
+#endif
+  }
+  colorBox(canvas, client, style.background);
+  return changed;
+}
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE Uint32
+NodeGraph::addNode(GraphNode node)
+{
+  auto i = Uint32(nodes.size());
+  // Smaller would cover no cell, so it could never be found
+  node.rect.w = std::max(node.rect.w, 1);
+  node.rect.h = std::max(node.rect.h, 1);
+  nodes.push_back(std::move(node));
+  nodeLinks.emplace_back();
+  nodeQueries.push_back(0);
+  placeNode(i, true);
+  return i;
+}
+
+DUI_INLINE Uint32
+NodeGraph::addLink(const GraphLink& link)
+{
+  SDL_assert(link.from < nodes.size() && link.to < nodes.size());
+  auto i = Uint32(links.size());
+  links.push_back(link);
+  linkQueries.push_back(0);
+  nodeLinks[link.from].push_back(i);
+  if (link.to != link.from) {
+    nodeLinks[link.to].push_back(i);
+  }
+  placeLink(i, true);
+  return i;
+}
+
+DUI_INLINE void
+NodeGraph::moveNode(Uint32 i, const SDL_Point& pos)
+{
+  placeNode(i, false);
+  for (auto link : nodeLinks[i]) {
+    placeLink(link, false);
+  }
+  nodes[i].rect.x = pos.x;
+  nodes[i].rect.y = pos.y;
+  placeNode(i, true);
+  for (auto link : nodeLinks[i]) {
+    placeLink(link, true);
+  }
+}
+
+DUI_INLINE void
+NodeGraph::placeNode(Uint32 i, bool insert)
+{
+  auto range = cellRange(nodes[i].rect);
+  for (int y = range.y; y <= range.y + range.h; ++y) {
+    for (int x = range.x; x <= range.x + range.w; ++x) {
+      auto& cell = cells[cellKey(x, y)];
+      if (insert) {
+        cell.nodes.push_back(i);
+        continue;
+      }
+      auto it = std::find(cell.nodes.begin(), cell.nodes.end(), i);
+      SDL_assert(it != cell.nodes.end());
+      *it = cell.nodes.back();
+      cell.nodes.pop_back();
+      if (cell.nodes.empty() && cell.links.empty()) {
+        cells.erase(cellKey(x, y));
+      }
+    }
+  }
+}
+
+DUI_INLINE void
+NodeGraph::placeLink(Uint32 i, bool insert)
+{
+  auto range = cellRange(linkBounds(links[i]));
+  if ((range.w + 1) * (range.h + 1) > MAX_LINK_CELLS) {
+    if (insert) {
+      longLinks.push_back(i);
+    } else {
+      auto it = std::find(longLinks.begin(), longLinks.end(), i);
+      SDL_assert(it != longLinks.end());
+      *it = longLinks.back();
+      longLinks.pop_back();
+    }
+    return;
+  }
+  for (int y = range.y; y <= range.y + range.h; ++y) {
+    for (int x = range.x; x <= range.x + range.w; ++x) {
+      auto& cell = cells[cellKey(x, y)];
+      if (insert) {
+        cell.links.push_back(i);
+        continue;
+      }
+      auto it = std::find(cell.links.begin(), cell.links.end(), i);
+      SDL_assert(it != cell.links.end());
+      *it = cell.links.back();
+      cell.links.pop_back();
+      if (cell.nodes.empty() && cell.links.empty()) {
+        cells.erase(cellKey(x, y));
+      }
+    }
+  }
+}
+
+DUI_INLINE void
+NodeGraph::query(const SDL_Rect& area,
+                 std::vector<Uint32>* foundNodes,
+                 std::vector<Uint32>* foundLinks)
+{
+  if (foundNodes) {
+    foundNodes->clear();
+  }
+  if (foundLinks) {
+    foundLinks->clear();
+  }
+  if (++queryCount == 0) {
+    // Wrapped around, forget the old marks
+    std::fill(nodeQueries.begin(), nodeQueries.end(), 0);
+    std::fill(linkQueries.begin(), linkQueries.end(), 0);
+    queryCount = 1;
+  }
+  auto visit = [&](const Cell& cell) {
+    if (foundNodes) {
+      for (auto i : cell.nodes) {
+        if (nodeQueries[i] != queryCount) {
+          nodeQueries[i] = queryCount;
+          if (SDL_HasIntersection(&nodes[i].rect, &area)) {
+            foundNodes->push_back(i);
+          }
+        }
+      }
+    }
+    if (foundLinks) {
+      for (auto i : cell.links) {
+        if (linkQueries[i] != queryCount) {
+          linkQueries[i] = queryCount;
+          auto bounds = linkBounds(links[i]);
+          if (SDL_HasIntersection(&bounds, &area)) {
+            foundLinks->push_back(i);
+          }
+        }
+      }
+    }
+  };
+  auto range = cellRange(area);
+  if (Uint64(range.w + 1) * Uint64(range.h + 1) > cells.size()) {
+    // Cheaper to look at all cells than at all positions
+    for (auto& [key, cell] : cells) {
+      int x = int(Sint32(key >> 32));
+      int y = int(Sint32(key & 0xFFFFFFFF));
+      if (x >= range.x && x <= range.x + range.w && y >= range.y &&
+          y <= range.y + range.h) {
+        visit(cell);
+      }
+    }
+  } else {
+    for (int y = range.y; y <= range.y + range.h; ++y) {
+      for (int x = range.x; x <= range.x + range.w; ++x) {
+        auto it = cells.find(cellKey(x, y));
+        if (it != cells.end()) {
+          visit(it->second);
+        }
+      }
+    }
+  }
+  if (foundLinks) {
+    for (auto i : longLinks) {
+      auto bounds = linkBounds(links[i]);
+      if (SDL_HasIntersection(&bounds, &area)) {
+        foundLinks->push_back(i);
+      }
+    }
+  }
+}
+
+DUI_INLINE Uint32
+NodeGraph::nodeAt(const SDL_Point& p) const
+{
+  auto it = cells.find(cellKey(cellOf(p.x), cellOf(p.y)));
+  if (it == cells.end()) {
+    return NONE;
+  }
+  Uint32 found = NONE;
+  for (auto i : it->second.nodes) {
+    if ((found == NONE || i > found) && SDL_PointInRect(&p, &nodes[i].rect)) {
+      found = i;
+    }
+  }
+  return found;
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_BOUNDED_MEMORY
+
+#endif // DUI_NODEEDITOR_HPP_
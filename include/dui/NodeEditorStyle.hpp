@@ -0,0 +1,76 @@
+#ifndef DUI_NODEEDITORSTYLE_HPP_
+#define DUI_NODEEDITORSTYLE_HPP_
+
+#include <SDL.h>
+#include "BoxStyle.hpp"
+#include "ButtonStyle.hpp"
+#include "ElementStyle.hpp"
+#include "Theme.hpp"
+
+namespace dui {
+
+// Style for node editor
+struct NodeEditorStyle
+{
+  SDL_Color background;
+  ElementStyle node;
+  ElementStyle selected;
+  SDL_Color link;
+  SDL_Color port;
+  int portSize;
+
+  constexpr NodeEditorStyle withBackground(SDL_Color background) const
+  {
+    return {background, node, selected, link, port, portSize};
+  }
+  constexpr NodeEditorStyle withNode(const ElementStyle& node) const
+  {
+    return {background, node, selected, link, port, portSize};
+  }
+  constexpr NodeEditorStyle withSelected(const ElementStyle& selected) const
+  {
+    return {background, node, selected, link, port, portSize};
+  }
+  constexpr NodeEditorStyle withLink(SDL_Color link) const
+  {
+    return {background, node, selected, link, port, portSize};
+  }
+  constexpr NodeEditorStyle withPort(SDL_Color port) const
+  {
+    return {background, node, selected, link, port, portSize};
+  }
+  constexpr NodeEditorStyle withPortSize(int portSize) const
+  {
+    return {background, node, selected, link, port, portSize};
+  }
+};
+
+struct NodeEditor;
+
+namespace style {
+
+template<class Theme>
+struct FromTheme<NodeEditor, Theme>
+{
+  constexpr static NodeEditorStyle get()
+  {
+    auto box = themeFor<Box, Theme>();
+    auto button = themeFor<ButtonBase, Theme>();
+    auto node = themeFor<Element, Theme>()
+                  .withBorder(EdgeSize::all(1))
+                  .withPaint(button.normal);
+    return {
+      box.paint.background,
+      node,
+      node.withPaint(button.grabbed),
+      box.paint.border.left,
+      box.paint.border.left,
+      6,
+    };
+  }
+};
+} // namespace style
+
+} // namespace dui
+
+#endif // DUI_NODEEDITORSTYLE_HPP_
@@ -0,0 +1,173 @@
+#ifndef DUI_OPTIONINDEX_HPP_
+#define DUI_OPTIONINDEX_HPP_
+
+#ifndef DUI_BOUNDED_MEMORY
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <SDL.h>
+#include "Config.hpp"
+
+namespace dui {
+
+/**
+ * @brief A list of options searchable by substring, ignoring case
+ *
+ * It keeps which options contain each sequence of up to 3 characters, so
+ * queries that short are just a lookup, and longer ones only check the
+ * options containing their rarest 3 characters, or the ones that matched
+ * last query, if it is a part of the new one. Building the index takes about
+ * 12 bytes for each character of the options, and for very large lists it
+ * might be better created on a State.job().
+ * @see comboBox()
+ */
+class OptionIndex
+{
+  std::vector<std::string> options;
+  std::string text;           // Lowercase options, each ended by '\0'
+  std::vector<Uint32> starts; // Start of each option on text, plus the end
+  std::unordered_map<Uint32, std::vector<Uint32>> grams;
+  std::vector<Uint32> all;
+  std::vector<Uint32> none;
+
+  std::string lastQuery; // Lowercase
+  std::vector<Uint32> lastResult;
+  std::vector<Uint32> scratch;
+
+  static char lower(char ch)
+  {
+    return ch >= 'A' && ch <= 'Z' ? char(ch - 'A' + 'a') : ch;
+  }
+
+  // Key of the n characters from p, with n from 1 to 3
+  static Uint32 gram(const char* p, size_t n)
+  {
+    Uint32 key = Uint32(n) << 24;
+    for (size_t i = 0; i < n; ++i) {
+      key |= Uint32(Uint8(p[i])) << (8 * i);
+    }
+    return key;
+  }
+
+  std::string_view lowered(Uint32 i) const
+  {
+    return {&text[starts[i]], starts[i + 1] - starts[i] - 1};
+  }
+
+  void narrow(const std::vector<Uint32>& candidates, std::string_view query);
+
+public:
+  /// Ctor
+  explicit OptionIndex(std::vector<std::string> options = {});
+
+  /// The options, in the given order
+  const std::vector<std::string>& getOptions() const { return options; }
+
+  /// The number of options
+  size_t size() const { return options.size(); }
+
+  /**
+   * @brief The options containing the query, ignoring ASCII case
+   *
+   * @param query the text to search
+   * @return const std::vector<Uint32>& the indices of the matching options, in
+   * order. It is valid until next call.
+   */
+  const std::vector<Uint32>& find(std::string_view query);
+};
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE OptionIndex::OptionIndex(std::vector<std::string> options)
+  : options(std::move(options))
+{
+  auto count = Uint32(this->options.size());
+  starts.reserve(count + 1);
+  all.reserve(count);
+  for (Uint32 i = 0; i < count; ++i) {
+    starts.push_back(Uint32(text.size()));
+    all.push_back(i);
+    for (auto ch : this->options[i]) {
+      text.push_back(lower(ch));
+    }
+    text.push_back('\0');
+  }
+  starts.push_back(Uint32(text.size()));
+  for (Uint32 i = 0; i < count; ++i) {
+    auto option = lowered(i);
+    for (size_t n = 1; n <= 3; ++n) {
+      for (size_t j = 0; j + n <= option.size(); ++j) {
+        auto& postings = grams[gram(&option[j], n)];
+        if (postings.empty() || postings.back() != i) {
+          postings.push_back(i);
+        }
+      }
+    }
+  }
+  lastResult = all;
+}
+
+DUI_INLINE const std::vector<Uint32>&
+OptionIndex::find(std::string_view query)
+{
+  std::string wanted;
+  wanted.reserve(query.size());
+  for (auto ch : query) {
+    wanted.push_back(lower(ch));
+  }
+  if (wanted == lastQuery) {
+    return lastResult;
+  }
+  if (wanted.empty()) {
+    lastResult = all;
+    lastQuery.clear();
+    return lastResult;
+  }
+  // The options with its rarest sequence of up to 3 characters
+  auto n = std::min(wanted.size(), size_t(3));
+  const std::vector<Uint32>* rarest = nullptr;
+  for (size_t j = 0; j + n <= wanted.size(); ++j) {
+    auto it = grams.find(gram(&wanted[j], n));
+    if (it == grams.end()) {
+      rarest = &none;
+      break;
+    }
+    if (!rarest || it->second.size() < rarest->size()) {
+      rarest = &it->second;
+    }
+  }
+  if (wanted.size() <= 3) {
+    lastResult = *rarest;
+  } else if (!lastQuery.empty() &&
+             wanted.find(lastQuery) != std::string::npos &&
+             lastResult.size() < rarest->size()) {
+    // Anything matching it matched the last one too
+    narrow(lastResult, wanted);
+  } else {
+    narrow(*rarest, wanted);
+  }
+  lastQuery = std::move(wanted);
+  return lastResult;
+}
+
+DUI_INLINE void
+OptionIndex::narrow(const std::vector<Uint32>& candidates,
+                    std::string_view query)
+{
+  scratch.clear();
+  for (auto i : candidates) {
+    if (lowered(i).find(query) != std::string_view::npos) {
+      scratch.push_back(i);
+    }
+  }
+  lastResult.swap(scratch);
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_BOUNDED_MEMORY
+
+#endif // DUI_OPTIONINDEX_HPP_
@@ -46,7 +46,7 @@ public:
 
   ~PanelImpl()
   {
-    if (wrapper) {
+    if (!wrapper.isEnded()) {
       end();
     }
   }
@@ -54,7 +54,7 @@ public:
   /// Finished the group
   void end()
   {
-    SDL_assert(wrapper);
+    SDL_assert(!wrapper.isEnded());
     auto sz = wrapper.end();
     auto rect = decoration.getRect();
     auto w = rect.w;
@@ -78,6 +78,12 @@ public:
   operator bool() const { return wrapper; }
 };
 
+#ifndef DUI_DEFINITIONS
+extern template class PanelImpl<Group>;
+#elif defined(DUI_COMPILED)
+template class PanelImpl<Group>;
+#endif
+
 /// Return the adjusted size for a given panel
 inline SDL_Point
 makePanelSize(SDL_Point defaultSize, Target target)
@@ -0,0 +1,148 @@
+#ifndef DUI_PARALLEL_HPP_
+#define DUI_PARALLEL_HPP_
+
+#ifndef DUI_BOUNDED_MEMORY
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "State.hpp"
+#include "Target.hpp"
+
+namespace dui {
+
+/// A set of independent contents built in parallel @see parallel()
+class ParallelImpl
+{
+  struct Fragment
+  {
+    State state;
+    SDL_Rect rect{0, 0, 0, 0};
+    SDL_Point topLeft;
+    SDL_Point bottomRight;
+    bool locked = false;
+
+    Fragment(const State& parent, const SDL_Point& caret)
+      : state(parent, State::Fork{})
+      , topLeft(caret)
+      , bottomRight(caret)
+    {}
+
+    operator Target() &
+    {
+      return {
+        &state, {}, rect, topLeft, bottomRight, locked, {0, Layout::NONE}};
+    }
+  };
+
+  Target parent;
+  std::vector<std::function<void(Target)>> tasks;
+  bool ended = false;
+
+public:
+  /// Ctor
+  ParallelImpl(Target parent)
+    : parent(parent)
+  {}
+
+  ParallelImpl(const ParallelImpl&) = delete;
+  ParallelImpl& operator=(const ParallelImpl&) = delete;
+
+  ~ParallelImpl()
+  {
+    if (!ended) {
+      end();
+    }
+  }
+
+  /**
+   * @brief Add a content to be built
+   *
+   * The function is called with a target on the current parent caret, with
+   * NONE layout, so it must position its elements explicitly. It might be
+   * called on any thread, at end().
+   *
+   * @param task a callable with the signature void(Target)
+   */
+  template<class TASK>
+  void add(TASK task)
+  {
+    SDL_assert(!ended);
+    tasks.emplace_back(std::move(task));
+  }
+
+  /**
+   * @brief Build all contents and add them to parent
+   *
+   * The contents are added in the order they were given, no matter which one
+   * finished first, so the result is the same than building them one by one.
+   */
+  void end();
+
+  /// Returns true if not ended
+  operator bool() const { return !ended; }
+};
+
+/**
+ * @brief Builds independent contents in parallel
+ * @ingroup groups
+ *
+ * Each content gets its own copy of the state, as it was when end() is
+ * called, and its own display list, that is added to parent's in order once
+ * all are built:
+ *
+ * ```
+ * auto p = dui::parallel(f);
+ * p.add([&](dui::Target t) { auto w = dui::window(t, "tools", ...); ... });
+ * p.add([&](dui::Target t) { auto w = dui::window(t, "scene", ...); ... });
+ * p.end();
+ * ```
+ *
+ * The contents must not share any data, except for reading, and must not touch
+ * the parent target nor the renderer, so elements creating textures, like
+ * heatmap(), must stay outside. The other elements keep what they remember
+ * between frames on the state, so they are fine. The worker threads are on
+ * State.getThreadPool(). Memo contents are not cached inside them.
+ *
+ * @param target the parent group or frame
+ * @return ParallelImpl
+ */
+inline ParallelImpl
+parallel(Target target)
+{
+  return {target};
+}
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE void
+ParallelImpl::end()
+{
+  SDL_assert(!ended);
+  ended = true;
+  if (tasks.empty()) {
+    return;
+  }
+  auto& state = parent.getState();
+  auto caret = parent.getCaret();
+  std::deque<Fragment> fragments;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    fragments.emplace_back(state, caret);
+  }
+  state.getThreadPool().parallelFor(
+    tasks.size(), [&](size_t i) { tasks[i](fragments[i]); });
+  SDL_Point extent{0, 0};
+  for (auto& fragment : fragments) {
+    state.join(fragment.state);
+    extent.x = std::max(extent.x, fragment.bottomRight.x - caret.x);
+    extent.y = std::max(extent.y, fragment.bottomRight.y - caret.y);
+  }
+  parent.advance(extent);
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_BOUNDED_MEMORY
+
+#endif // DUI_PARALLEL_HPP_
@@ -0,0 +1,42 @@
+#ifndef DUI_PROGRESSBAR_HPP_
+#define DUI_PROGRESSBAR_HPP_
+
+#include <algorithm>
+#include <SDL.h>
+#include "Box.hpp"
+#include "Group.hpp"
+#include "ProgressBarStyle.hpp"
+#include "Target.hpp"
+
+namespace dui {
+
+/**
+ * @brief A bar filled proportionally to a value
+ * @ingroup elements
+ *
+ * @param target the parent group or frame
+ * @param value the filled portion, from 0 to 1
+ * @param r the bar local position and size
+ * @param style
+ */
+inline void
+progressBar(Target target,
+            float value,
+            const SDL_Rect& r,
+            const ProgressBarStyle& style = themeFor<ProgressBar>())
+{
+  auto& border = style.box.border;
+  int clientW = r.w - border.left - border.right;
+  auto g = group(target, {}, {0}, Layout::NONE);
+  colorBox(g,
+           {r.x + border.left,
+            r.y + border.top,
+            int(clientW * std::clamp(value, 0.f, 1.f)),
+            r.h - border.top - border.bottom},
+           style.bar);
+  box(g, r, style.box);
+}
+
+} // namespace dui
+
+#endif // DUI_PROGRESSBAR_HPP_
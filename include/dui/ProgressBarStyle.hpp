@@ -0,0 +1,46 @@
+#ifndef DUI_PROGRESSBARSTYLE_HPP_
+#define DUI_PROGRESSBARSTYLE_HPP_
+
+#include <SDL.h>
+#include "BoxStyle.hpp"
+#include "ButtonStyle.hpp"
+#include "Theme.hpp"
+
+namespace dui {
+
+// Style for progress bar
+struct ProgressBarStyle
+{
+  BoxStyle box;
+  SDL_Color bar;
+
+  constexpr ProgressBarStyle withBox(const BoxStyle& box) const
+  {
+    return {box, bar};
+  }
+  constexpr ProgressBarStyle withBar(SDL_Color bar) const
+  {
+    return {box, bar};
+  }
+};
+
+struct ProgressBar;
+
+namespace style {
+
+template<class Theme>
+struct FromTheme<ProgressBar, Theme>
+{
+  constexpr static ProgressBarStyle get()
+  {
+    return {
+      themeFor<Box, Theme>(),
+      themeFor<ButtonBase, Theme>().normal.background,
+    };
+  }
+};
+} // namespace style
+
+} // namespace dui
+
+#endif // DUI_PROGRESSBARSTYLE_HPP_
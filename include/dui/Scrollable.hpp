@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cmath>
 #include <string_view>
 #include "Panel.hpp"
 #include "ScrollableStyle.hpp"
@@ -7,6 +8,19 @@
 #include "Wrapper.hpp"
 
 namespace dui {
+
+/// The offset to show, moving smoothly to the given one in duration ms
+inline SDL_Point
+smoothScrollOffset(Target target, const SDL_Point& offset, Uint32 duration)
+{
+  if (duration == 0) {
+    return offset;
+  }
+  auto& state = target.getState();
+  return {int(std::lround(state.animate("scrollX", offset.x, duration))),
+          int(std::lround(state.animate("scrollY", offset.y, duration)))};
+}
+
 /// Scrollable class. @see scrollable() and scrollablePanel()
 class Scrollable : public Targetable<Scrollable>
 {
@@ -15,6 +29,16 @@ class Scrollable : public Targetable<Scrollable>
   Wrapper<Group> wrapper;
   SDL_Point* scrollOffset;
 
+  // Recording of the content, when over the frame budget
+  MemoEntry* entry = nullptr;
+  SDL_Point origin;
+  size_t start;
+  int layerCount;
+  int dropped;
+  bool replayed = false;
+
+  void throttle(State& state, int interval);
+
 public:
   /// Ctor
   Scrollable(Target parent,
@@ -27,17 +51,33 @@ public:
     , wrapper(decoration,
               evalPadding(style),
               [=](auto t, auto r) {
-                return offsetGroup(t, "client", *scrollOffset, r, style);
+                auto offset =
+                  smoothScrollOffset(t, *scrollOffset, style.smoothScroll);
+                return offsetGroup(t, "client", offset, r, style);
               })
     , scrollOffset(scrollOffset)
-  {}
+  {
+    auto& state = parent.getState();
+    auto interval = state.getGovernor().scrollInterval;
+    if (interval > 1) {
+      throttle(state, interval);
+    }
+  }
   /// Move ctor
   Scrollable(Scrollable&& rhs)
     : style(rhs.style)
     , decoration(std::move(rhs.decoration))
     , wrapper(std::move(rhs.wrapper), decoration)
     , scrollOffset(rhs.scrollOffset)
-  {}
+    , entry(rhs.entry)
+    , origin(rhs.origin)
+    , start(rhs.start)
+    , layerCount(rhs.layerCount)
+    , dropped(rhs.dropped)
+    , replayed(rhs.replayed)
+  {
+    rhs.entry = nullptr;
+  }
 
   /// Move assign operator
   Scrollable& operator=(const Scrollable&) = delete;
@@ -58,6 +98,20 @@ public:
   /// Finished the group
   void end()
   {
+    if (entry) {
+      Target client = wrapper;
+      auto& state = client.getState();
+      auto& dList = state.getDisplayList();
+      entry->valid = state.getLayerCount() == layerCount &&
+                     dList.getDropped() == dropped;
+      if (entry->valid) {
+        dList.record(start, entry->recording);
+        entry->builtFrame = state.getFrameCount();
+        entry->rect = {
+          origin.x, origin.y, client.contentWidth(), client.contentHeight()};
+      }
+      entry = nullptr;
+    }
     SDL_Point clientSize{wrapper.width(), wrapper.height()};
     SDL_Point decorationSize{wrapper.end()};
     auto rect = decoration.getRect();
@@ -80,7 +134,9 @@ public:
                    0,
                    padding.right,
                    decorationSize.y,
-                 });
+                 },
+                 themeFor<SliderBox>(),
+                 false);
     }
     if (padding.bottom > 0) {
       sliderBox(decoration,
@@ -93,18 +149,66 @@ public:
                   decorationSize.y - padding.bottom,
                   decorationSize.x - padding.right,
                   padding.bottom,
-                });
+                },
+                themeFor<SliderBox>(),
+                false);
     }
     decoration.end();
   }
 
-  /// Return true if it can accept elements
-  operator bool() const { return wrapper; }
+  /**
+   * @brief Return true if it can accept elements
+   *
+   * If over the frame budget, it might be false for some frames while the
+   * content has no input, and the content of the last time is shown instead.
+   * @see State.setFrameBudget()
+   */
+  operator bool() const { return wrapper && !replayed; }
 
   /// Returns target object
   operator Target() { return wrapper; }
 };
 
+#ifndef DUI_DEFINITIONS
+extern template class Wrapper<Scrollable>;
+extern template class PanelImpl<Scrollable>;
+#elif defined(DUI_COMPILED)
+template class Wrapper<Scrollable>;
+template class PanelImpl<Scrollable>;
+#endif
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE void
+Scrollable::throttle(State& state, int interval)
+{
+  // What can be seen is always current
+  if (!state.isClippedOut()) {
+    return;
+  }
+  entry = state.getMemo();
+  if (!entry) {
+    return;
+  }
+  Target client = wrapper;
+  origin = client.getCaret();
+  auto& rect = entry->rect;
+  auto age = state.getFrameCount() - entry->builtFrame;
+  if (entry->valid && age < Uint32(interval) &&
+      !state.hasGroupInput({origin.x, origin.y, rect.w, rect.h})) {
+    state.getDisplayList().replay(entry->recording,
+                                  {origin.x - rect.x, origin.y - rect.y});
+    state.touchGroup();
+    client.setContentSize({rect.w, rect.h});
+    replayed = true;
+    entry = nullptr;
+    return;
+  }
+  start = state.getDisplayList().mark();
+  layerCount = state.getLayerCount();
+  dropped = state.getDisplayList().getDropped();
+}
+#endif // DUI_DEFINITIONS
+
 /// Eval the scrollable size according with parameters
 inline SDL_Point
 makeScrollableSize(const SDL_Point& defaultSize, Target target)
@@ -187,8 +291,8 @@ scrollablePanel(Target target,
   return {target,
           id,
           makeScrollableRect(r, target),
-          [=](auto t, auto r) {
-            return scrollable(t, "client", scrollOffset, r, style);
+          [scrollOffset, client = ScrollableStyle(style)](auto t, auto r) {
+            return scrollable(t, "client", scrollOffset, r, client);
           },
           style};
 }
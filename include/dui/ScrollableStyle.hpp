@@ -11,25 +11,31 @@ struct ScrollableStyle
   bool fixVertical;
   SliderBoxStyle slider;
   GroupStyle client;
+  Uint32 smoothScroll; ///< Milliseconds to scroll to a new offset, 0 is instant
 
   constexpr ScrollableStyle withFixHorizontal(bool fixHorizontal) const
   {
-    return {fixHorizontal, fixVertical, slider, client};
+    return {fixHorizontal, fixVertical, slider, client, smoothScroll};
   }
 
   constexpr ScrollableStyle withFixVertical(bool fixVertical) const
   {
-    return {fixHorizontal, fixVertical, slider, client};
+    return {fixHorizontal, fixVertical, slider, client, smoothScroll};
   }
 
   constexpr ScrollableStyle withSlider(SliderBoxStyle slider) const
   {
-    return {fixHorizontal, fixVertical, slider, client};
+    return {fixHorizontal, fixVertical, slider, client, smoothScroll};
   }
 
   constexpr ScrollableStyle withClient(const GroupStyle& client) const
   {
-    return {fixHorizontal, fixVertical, slider, client};
+    return {fixHorizontal, fixVertical, slider, client, smoothScroll};
+  }
+
+  constexpr ScrollableStyle withSmoothScroll(Uint32 smoothScroll) const
+  {
+    return {fixHorizontal, fixVertical, slider, client, smoothScroll};
   }
 
   constexpr ScrollableStyle withElementSpacing(int elementSpacing) const
@@ -90,6 +96,7 @@ struct FromTheme<Scrollable, Theme>
       false,                        // Fix vertical
       themeFor<SliderBox, Theme>(), // scrollable
       themeFor<Group, Theme>(),     // group
+      0,                            // smooth scroll
     };
   }
 };
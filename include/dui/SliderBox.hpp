@@ -11,28 +11,37 @@
 
 namespace dui {
 
-/// Returns delta
+/**
+ * @brief The draggable caret of a slider box bar
+ *
+ * @param target the parent group
+ * @param id the caret id
+ * @param r the caret rect
+ * @param style the caret style
+ * @param bounds where the caret can be dragged, used to late latch it while
+ * dragging (@see State.setLatching()). If empty, it is never latched.
+ * @param steps in how many steps the caret moves across the free space in
+ * bounds on each axis, so the latched caret snaps like the value it shows. If
+ * 0, it moves freely.
+ * @return the delta, if grabbed
+ */
 inline std::optional<SDL_Point>
 sliderBoxBarCaret(Target target,
                   std::string_view id,
                   const SDL_Rect& r,
-                  const BoxStyle& style = themeFor<Box>())
+                  const BoxStyle& style = themeFor<Box>(),
+                  const SDL_Rect& bounds = {0},
+                  SDL_Point steps = {0, 0})
 {
-  box(target, r, style);
-  static SDL_Point mouseOffset;
   auto action = target.checkMouse(id, r);
-  if (action == MouseAction::HOLD) {
-    return {{0, 0}};
-  }
-  if (action == MouseAction::GRAB) {
-    auto pos = target.lastMousePos();
-    mouseOffset = {pos.x - r.x, pos.y - r.y};
-    return {{0, 0}};
-  }
-  if (action != MouseAction::DRAG) {
+  if (action == MouseAction::NONE) {
+    box(target, r, style);
     return {};
   }
+  auto& state = target.getState();
   auto pos = target.lastMousePos();
+  auto mouseOffset = state.grabOffset();
+  // The motion from the grabbed point, held until the mouse leaves the caret
   SDL_Point delta{pos.x - r.x - mouseOffset.x, pos.y - r.y - mouseOffset.y};
   if (delta.x > 0 ? pos.x < r.x : pos.x > r.x) {
     delta.x = 0;
@@ -40,6 +49,26 @@ sliderBoxBarCaret(Target target,
   if (delta.y > 0 ? pos.y < r.y : pos.y > r.y) {
     delta.y = 0;
   }
+  if (state.isLatching() && !SDL_RectEmpty(&bounds)) {
+    auto caret = target.getCaret();
+    auto& dList = state.getDisplayList();
+    dList.popLatch();
+    box(target, r, style);
+    SDL_Rect globalBounds = bounds;
+    globalBounds.x += caret.x;
+    globalBounds.y += caret.y;
+    // The delta not yet applied counts when snapping the motion to steps
+    dList.pushLatch(
+      {r.x + caret.x, r.y + caret.y, r.w, r.h}, globalBounds, steps, delta);
+  } else {
+    box(target, r, style);
+  }
+  if (action == MouseAction::HOLD || action == MouseAction::GRAB) {
+    return {{0, 0}};
+  }
+  if (action != MouseAction::DRAG) {
+    return {};
+  }
   return delta;
 }
 
@@ -50,7 +79,13 @@ enum Orientation : bool
   VERTICAL,
 };
 
-/// The draggable bar part of a slider box
+/**
+ * @brief The draggable bar part of a slider box
+ *
+ * @param latched if true, the caret is late latched while dragged (@see
+ * State.setLatching()). Scrollbars are not, as their content would not move
+ * with the caret.
+ */
 inline bool
 sliderBoxBar(Target target,
              std::string_view id,
@@ -59,7 +94,8 @@ sliderBoxBar(Target target,
              int max,
              const SDL_Rect& r,
              Orientation orientation,
-             const SliderBoxBarStyle& style = themeFor<SliderBoxBar>())
+             const SliderBoxBarStyle& style = themeFor<SliderBoxBar>(),
+             bool latched = true)
 {
   SDL_assert(value != nullptr);
   auto g = panel(target, id, r, Layout::NONE, style.panel);
@@ -68,13 +104,16 @@ sliderBoxBar(Target target,
   int distance = max - min;
   int cursorMax;
   SDL_Rect cursorRect;
+  SDL_Point steps{0, 0};
   if (orientation == HORIZONTAL) {
+    steps.x = distance;
     int cursorW = std::max(r.w / distance, style.minCursor);
     cursorMax = r.w - cursorW;
     int cursorPos =
       std::clamp((*value - min) * cursorMax / distance, 0, cursorMax);
     cursorRect = {cursorPos - 1, -1, cursorW, r.h};
   } else {
+    steps.y = distance;
     int cursorH = std::max(r.h / distance, style.minCursor);
     cursorMax = r.h - cursorH;
     int cursorPos =
@@ -82,7 +121,12 @@ sliderBoxBar(Target target,
     cursorRect = {-1, cursorPos - 1, r.w, cursorH};
   }
 
-  if (auto result = sliderBoxBarCaret(g, "caret", cursorRect, style.cursor)) {
+  SDL_Rect bounds{0};
+  if (latched) {
+    bounds = {-1, -1, r.w, r.h};
+  }
+  if (auto result =
+        sliderBoxBarCaret(g, "caret", cursorRect, style.cursor, bounds, steps)) {
     int delta = orientation == HORIZONTAL ? result->x * distance / cursorMax
                                           : result->y * distance / cursorMax;
     if (delta == 0) {
@@ -122,7 +166,7 @@ sliderBoxBar(Target target,
   return true;
 }
 
-/// An horizontal slider box
+/// An horizontal slider box, latched as sliderBoxBar()
 /// @ingroup elements
 inline bool
 sliderBox(Target target,
@@ -131,7 +175,8 @@ sliderBox(Target target,
           int min,
           int max,
           SDL_Rect r = {0},
-          const SliderBoxStyle& style = themeFor<SliderBox>())
+          const SliderBoxStyle& style = themeFor<SliderBox>(),
+          bool latched = true)
 {
   if (r.w == 0) {
     r.w = makeInputSize({r.w, r.h},
@@ -171,11 +216,12 @@ sliderBox(Target target,
                  max,
                  {buttonWidth - 1, 0, r.w - buttonWidth * 2 + 2, buttonHeight},
                  HORIZONTAL,
-                 style.bar);
+                 style.bar,
+                 latched);
   return action;
 }
 
-/// A vertical slider box
+/// A vertical slider box, latched as sliderBoxBar()
 /// @ingroup elements
 inline bool
 sliderBoxV(Target target,
@@ -184,7 +230,8 @@ sliderBoxV(Target target,
            int min,
            int max,
            SDL_Rect r = {0},
-           const SliderBoxStyle& style = themeFor<SliderBox>())
+           const SliderBoxStyle& style = themeFor<SliderBox>(),
+           bool latched = true)
 {
   if (r.h == 0) {
     r.h = makeInputSize({0},
@@ -222,7 +269,8 @@ sliderBoxV(Target target,
                  max,
                  {0, buttonHeight - 1, buttonWidth, r.h - buttonHeight * 2 + 2},
                  VERTICAL,
-                 style.bar);
+                 style.bar,
+                 latched);
   return action;
 }
 
@@ -1,15 +1,46 @@
 #ifndef DUI_STATE_HPP_
 #define DUI_STATE_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <SDL.h>
+#include "Animation.hpp"
+#include "Config.hpp"
 #include "DisplayList.hpp"
+#include "FixedString.hpp"
 #include "Font.hpp"
+#include "Format.hpp"
+#include "FrameArena.hpp"
+#include "FrameStats.hpp"
+#include "Governor.hpp"
+#include "Job.hpp"
+#include "LatencyHistogram.hpp"
+#include "LineBreaks.hpp"
+#ifndef DUI_BOUNDED_MEMORY
+#include <thread>
+#include "ThreadPool.hpp"
+#include "UpdateQueue.hpp"
+#endif
 
 namespace dui {
 
 constexpr char groupNameSeparator = '/';
 
+/// String type holding qualified ids
+#ifdef DUI_BOUNDED_MEMORY
+using IdString = FixedString<DUI_MAX_ID_SIZE>;
+#else
+using IdString = std::string;
+#endif
+
 /**
  * @brief The mouse action and status for a element in a frame
  *
@@ -35,6 +66,57 @@ enum class TextAction
   KEYDOWN, ///< erased last character
 };
 
+/**
+ * @brief What the active text box keeps while edited
+ *
+ */
+struct TextEdit
+{
+  static constexpr int BUFFER_SIZE = 256; ///< Buffer size
+  size_t cursor = 0;                      ///< The cursor position
+  size_t maxCursor = 0;                   ///< The text end
+  char buffer[BUFFER_SIZE] = {0}; ///< The text, if not backed by a string
+};
+
+/**
+ * @brief Cached content of a memo() region
+ *
+ */
+struct MemoEntry
+{
+  std::string key;                  ///< The region qualified id
+  size_t depsHash;                  ///< Hash of the dependencies
+  SDL_Rect rect;                    ///< The region global rect when recorded
+  DisplayList::Recording recording; ///< The region commands
+  Uint32 builtFrame;                ///< Frame it was recorded
+  Uint32 lastFrame;                 ///< Last frame it was used
+  bool valid;                       ///< If the recording can be replayed
+};
+
+/**
+ * @brief Triangles of a shape cached by State.tessellate()
+ *
+ */
+struct GeometryEntry
+{
+  std::vector<Uint32> key;       ///< The shape kind and parameters
+  std::vector<SDL_Point> points; ///< The shape points, from the first one
+  std::vector<Vertex> vertices;  ///< The triangles, from the shape origin
+  Uint32 lastFrame;              ///< Last frame it was used
+};
+
+/**
+ * @brief Line breaks of a text cached by State.forEachLine()
+ *
+ */
+struct TextLinesEntry
+{
+  std::string text;            ///< The wrapped text
+  size_t columns;              ///< Characters per line
+  std::vector<TextLine> lines; ///< The lines
+  Uint32 lastFrame;            ///< Last frame it was used
+};
+
 /**
  * @brief Stores the ui state
  *
@@ -48,24 +130,79 @@ class State
   SDL_Renderer* renderer;
   DisplayList dList;
   int lastMaxZIndex = 0;
+  FrameStats stats{0};
+  bool culling = true;
+  bool optimizing = true;
+  bool latching = false;
+  Uint32 frameBudget = 0;
+  Governor governor;
+  Uint64 buildStart = 0;
+  Uint32 buildTime = 0;
 
   SDL_Point mPos;
+  SDL_Point mWheel{0, 0};
   bool mLeftPressed = false;
-  std::string eGrabbed;
+  IdString eGrabbed;
+  SDL_Point mGrabOffset{0, 0};
   bool mHovering = false;
   bool mGrabbing = false;
   bool mReleasing = false;
-  std::string eActive;
+  IdString eActive;
   char tBuffer[SDL_TEXTINPUTEVENT_TEXT_SIZE];
+  TextEdit tEdit;
+  bool tEditUsed = false;
   SDL_Keysym tKeysym;
   bool tChanged = false;
   TextAction tAction = TextAction::NONE;
 
-  std::string group;
+  IdString group;
+  int droppedGroups = 0; // Groups whose id did not fit on group
   bool gGrabbed = false;
   bool gActive = false;
+#ifndef DUI_BOUNDED_MEMORY
+  // What the fixed size groups being built leave visible, to pause animations
+  SDL_Rect visible{0, 0, 0, 0};
+  std::vector<SDL_Rect> visibleStack;
+#endif
 
   Uint32 ticksCount;
+  Uint32 frameCount = 0;
+
+  // Oldest input not yet in a frame and oldest in a frame not yet presented
+  static constexpr int INPUT_KINDS = int(InputKind::COUNT);
+  Uint64 pendingInput[INPUT_KINDS] = {0};
+  Uint64 frameInput[INPUT_KINDS] = {0};
+  LatencyHistogram latencies[INPUT_KINDS];
+  int layerCount = 0;
+
+  FrameArena arena;
+#ifdef DUI_BOUNDED_MEMORY
+  VertexBuffer geometryScratch;
+#else
+  std::unordered_map<size_t, MemoEntry> memos;
+  std::unordered_map<size_t, GeometryEntry> geometries;
+  std::unordered_map<size_t, TextLinesEntry> textLines;
+  std::unordered_map<size_t, Tween> tweens;
+#endif
+  static constexpr Uint32 NO_UPDATE = Uint32(-1);
+  static constexpr Uint32 TWEEN_TIMEOUT = 1024; // Frames a paused tween lasts
+  Uint32 nextUpdate = NO_UPDATE;
+#ifndef DUI_BOUNDED_MEMORY
+  std::unique_ptr<ThreadPool> pool;
+  UpdateQueue updates;
+  std::atomic<bool> wakePending{false};
+  Uint32 wakeEvent = Uint32(-1);
+  std::unordered_map<size_t, JobEntry> jobs;
+  // Forks read the caches through their parent, which is not changed while
+  // they build, and hold only the entries they changed or read
+  const State* parentState = nullptr;
+  std::vector<size_t> usedGeometries;
+  std::vector<size_t> usedTextLines;
+  std::thread::id renderThread = std::this_thread::get_id();
+  static constexpr unsigned JOB_WORKERS = 2;
+  // Last, so its workers stop before what they use is destroyed
+  std::unique_ptr<ThreadPool> jobPool;
+#endif
 
   Font font;
   int width = 0;
@@ -78,8 +215,157 @@ public:
     , font(loadDefaultFont(renderer))
   {
     SDL_GetRendererOutputSize(renderer, &width, &height);
+#ifndef DUI_BOUNDED_MEMORY
+    wakeEvent = SDL_RegisterEvents(1);
+#endif
+  }
+
+#ifndef DUI_BOUNDED_MEMORY
+  /// Dtor. Cancels the jobs and waits for the running ones
+  ~State()
+  {
+    if (parentState) {
+      return;
+    }
+    for (auto& [hash, entry] : jobs) {
+      entry.control->cancel();
+    }
+  }
+
+  /// Tag to select the fork ctor
+  struct Fork
+  {};
+
+  /**
+   * @brief Creates a state to build part of parent's frame on another thread
+   *
+   * The fork gets a copy of the parent input and group context, so elements
+   * built on it behave as if they were built on the parent at this point, but
+   * it has its own display list and touches nothing on the parent. It reads
+   * the animations, jobs and the tessellation and line break caches through
+   * the parent, keeping only the entries it changed or read, and has an empty
+   * State.format() memory. Use join() to add its content back, along with
+   * those entries.
+   *
+   * @param parent the state, it must be in frame
+   */
+  State(const State& parent, Fork);
+
+  /**
+   * @brief Add the content and the input changes of a fork
+   *
+   * Forks must be joined in the same order their content would have been built
+   * on this. If more than one grabbed the mouse, the first joined wins.
+   *
+   * @param fork a state created with the fork ctor from this, its cache
+   * entries are moved out
+   */
+  void join(State& fork);
+
+  /// The pool used to build in parallel, created on first use
+  ThreadPool& getThreadPool()
+  {
+    if (!pool) {
+      pool = std::make_unique<ThreadPool>();
+    }
+    return *pool;
+  }
+
+  /**
+   * @brief Set the number of worker threads used to build in parallel
+   *
+   * @param count the number of threads, if 0 it uses one less than the number
+   * of hardware threads.
+   */
+  void setWorkerCount(unsigned count)
+  {
+    pool = std::make_unique<ThreadPool>(count);
+  }
+
+  /**
+   * @brief Post a function to be called at the beginning of next frame
+   *
+   * This is the only method that can be called from any thread. It never
+   * blocks, and if the event loop is waiting for events, it wakes it up by
+   * pushing an event of getWakeEventType().
+   *
+   * @param update the function, called on the ui thread
+   */
+  void post(std::function<void()> update);
+
+  /**
+   * @brief Post a value to be assigned to target at the beginning of next frame
+   *
+   * Use this to change values bound to elements from other threads:
+   *
+   * ```
+   * state.post(&progress, 0.5);
+   * ```
+   *
+   * @param target where to assign, it must live until next frame begins
+   * @param value the value
+   */
+  template<class T, class U>
+  void post(T* target, U&& value)
+  {
+    post([target, value = std::forward<U>(value)] { *target = value; });
+  }
+
+  /// The SDL event type pushed by post(). You can ignore these events
+  Uint32 getWakeEventType() const { return wakeEvent; }
+
+  /**
+   * @brief Run a function on a worker thread, keyed by id
+   *
+   * The first time it is called for an id it starts the job. Next calls return
+   * the same job, that is done when the function returns. While it runs, the
+   * ui is built as usual:
+   *
+   * ```
+   * auto files = state.job("files", [dir](dui::JobControl& control) {
+   *   return listFiles(dir, control);
+   * });
+   * if (auto list = files.get()) { ... }
+   * ```
+   *
+   * A job that is not asked for on a frame is cancelled and forgotten, so
+   * a new one starts if it is asked for again. The function should check
+   * JobControl.isCancelled() now and then, and can report its progress with
+   * JobControl.setProgress(). It must be copyable, and it must not touch the
+   * ui state nor anything the ui thread changes, except through post().
+   *
+   * @param id the job id, on the current group
+   * @param work a callable with the signature T(JobControl&)
+   * @return Job<T> the job handle
+   */
+  template<class FUNC>
+  auto job(std::string_view id, FUNC work)
+    -> Job<std::invoke_result_t<FUNC&, JobControl&>>;
+
+  /// The pool running the jobs, created on first use
+  ThreadPool& getJobPool()
+  {
+    if (!jobPool) {
+      jobPool = std::make_unique<ThreadPool>(JOB_WORKERS);
+    }
+    return *jobPool;
   }
 
+  /**
+   * @brief Set the number of worker threads running the jobs
+   *
+   * Jobs already started keep running on the previous threads, and this waits
+   * until they finish.
+   *
+   * @param count the number of threads, if 0 it uses one less than the number
+   * of hardware threads.
+   */
+  void setJobWorkerCount(unsigned count)
+  {
+    jobPool = std::make_unique<ThreadPool>(count);
+  }
+#endif
+
   /**
    * @brief Render the ui
    *
@@ -90,7 +376,43 @@ public:
   void render()
   {
     SDL_assert(!inFrame);
-    dList.render(renderer);
+#ifndef DUI_BOUNDED_MEMORY
+    SDL_assert(std::this_thread::get_id() == renderThread);
+#endif
+    auto start = SDL_GetPerformanceCounter();
+    dList.render(renderer, &stats, latchDelta());
+    auto end = SDL_GetPerformanceCounter();
+    governor.update(buildTime, elapsedMicroseconds(start, end), frameBudget);
+  }
+
+  /**
+   * @brief Present the rendered ui, measuring the input latency
+   *
+   * Call it instead of SDL_RenderPresent(). The time from the first event of
+   * each kind handled by event() until the frame it changed is presented is
+   * counted on getLatency().
+   */
+  void present();
+
+  /**
+   * @brief Latencies from input to presentation
+   *
+   * Only measured if present() is used.
+   *
+   * @param kind the input kind
+   * @return const LatencyHistogram& the latencies, in microseconds
+   */
+  const LatencyHistogram& getLatency(InputKind kind) const
+  {
+    return latencies[int(kind)];
+  }
+
+  /// Forget all measured latencies
+  void resetLatency()
+  {
+    for (auto& histogram : latencies) {
+      histogram.clear();
+    }
   }
 
   /**
@@ -177,6 +499,46 @@ public:
    */
   SDL_Point lastMousePos() const { return mPos; }
 
+  /**
+   * @brief Where the grabbed element was grabbed, from its top left
+   *
+   * It is set when checkMouse() returns GRAB.
+   */
+  SDL_Point grabOffset() const { return mGrabOffset; }
+
+  /**
+   * @brief The edit state of the active text box
+   *
+   * Only the element for which isActive() is true may use it.
+   */
+  TextEdit& getTextEdit()
+  {
+    tEditUsed = true;
+    return tEdit;
+  }
+
+  /**
+   * @brief Mouse wheel scrolled since last frame
+   *
+   * @return SDL_Point the horizontal and vertical amounts, y positive is away
+   * from the user
+   */
+  SDL_Point lastWheel() const { return mWheel; }
+
+  /**
+   * @brief Check if the mouse is over the given rect with nothing on top
+   *
+   * What covers it is what was added before it, as the first added is on top,
+   * and the upper layers of the last frame. Use it to take the wheel.
+   *
+   * @param r the global rect
+   */
+  bool isHovered(const SDL_Rect& r) const
+  {
+    return !mHovering && dList.getZIndex() >= lastMaxZIndex &&
+           SDL_PointInRect(&mPos, &r);
+  }
+
   /**
    * @brief If true, the state wants the mouse events
    */
@@ -196,16 +558,276 @@ public:
    */
   void display(const Shape& item) { dList.insert(item); }
 
+  /**
+   * @brief Add connected line segments to display list
+   *
+   * @param points the points
+   * @param count the number of points, at least 2
+   * @param c the color
+   * @param offset added to each point to make it on screen coordinates
+   */
+  void displayPolyline(const SDL_Point* points,
+                       size_t count,
+                       SDL_Color c,
+                       const SDL_Point& offset = {0, 0})
+  {
+    dList.insertPolyline(points, count, c, offset);
+  }
+
+  /// Add triangles to the display list. @see DisplayList.insertGeometry()
+  void displayGeometry(const Vertex* vertices,
+                       size_t count,
+                       const SDL_Point& offset = {0, 0})
+  {
+    dList.insertGeometry(vertices, count, offset);
+  }
+
+  /**
+   * @brief Tessellate a shape, reusing the triangles of an equal shape from
+   * this or the last frame
+   *
+   * The triangles must not depend on the shape position, so moved shapes are
+   * reused too. On bounded memory nothing is cached.
+   *
+   * @param key the shape kind and parameters
+   * @param points the shape points, compared relative to the first one
+   * @param count the number of points
+   * @param fill called to tessellate on a miss, with an empty VertexBuffer
+   * @return const VertexBuffer& the triangles, valid until next frame
+   */
+  template<class FILL>
+  const VertexBuffer& tessellate(std::initializer_list<Uint32> key,
+                                 const SDL_Point* points,
+                                 size_t count,
+                                 FILL fill);
+
+  /**
+   * @brief Call a function for each line of a wrapped text
+   *
+   * The line breaks are kept while the same text is wrapped on the same
+   * columns on each frame, so unchanged paragraphs are not broken again. On
+   * bounded memory they are found every time. @see nextLine()
+   *
+   * @param str the text
+   * @param columns the characters that fit on a line, at least 1
+   * @param f called with each TextLine
+   */
+  template<class F>
+  void forEachLine(std::string_view str, size_t columns, F f);
+
+  /**
+   * @brief Format a text on memory that lasts until the next frame begins
+   *
+   * Nothing is allocated once the memory used by previous frames fits the
+   * current one. On bounded memory texts that do not fit DUI_MAX_FRAME_TEXT
+   * are cut. On a parallel() content, the text lasts until the content ends.
+   *
+   * @param fmt the format. @see formatTo()
+   * @param args the arguments
+   * @return std::string_view the text
+   */
+  template<class... ARGS>
+  std::string_view format(std::string_view fmt, const ARGS&... args)
+  {
+    auto space = arena.space(fmt.size());
+    FormatBuffer out{space.data, space.size};
+    formatTo(out, fmt, args...);
+    if (!out.fits()) {
+      space = arena.space(out.getSize());
+      out = FormatBuffer{space.data, space.size};
+      formatTo(out, fmt, args...);
+    }
+    auto text = out.view();
+    arena.commit(text.size());
+    return text;
+  }
+
   /// Ticks count
   Uint32 ticks() const { return ticksCount; }
 
+  /// Counters from the last rendered frame
+  const FrameStats& getFrameStats() const { return stats; }
+
+  /// Memory footprint of the display list
+  MemoryStats getMemoryStats() const { return dList.getMemoryStats(); }
+
+  /**
+   * @brief Enable or disable the occlusion culling
+   *
+   * If enabled (the default), shapes hidden behind opaque boxes are removed at
+   * the end of each frame. @see DisplayList.cull()
+   */
+  void setCulling(bool enabled) { culling = enabled; }
+
+  /// If occlusion culling is enabled
+  bool isCulling() const { return culling; }
+
+  /**
+   * @brief Enable or disable the display list optimization
+   *
+   * If enabled (the default), useless commands are removed and abutting boxes
+   * merged at the end of each frame. @see DisplayList.optimize()
+   */
+  void setOptimizing(bool enabled) { optimizing = enabled; }
+
+  /// If the display list optimization is enabled
+  bool isOptimizing() const { return optimizing; }
+
+  /**
+   * @brief Enable or disable the late latching of dragged shapes
+   *
+   * If enabled, shapes being dragged, like the slider and scrollbar carets,
+   * are moved at render() to follow the mouse motion events that arrived
+   * after the frame was built. This saves a frame of drag latency. Call
+   * pumpLatch() just before render() to get the latest motion. It is disabled
+   * by default, and has no effect while the renderer has a logical size or a
+   * scale, as the mouse state is not mapped like the events are.
+   */
+  void setLatching(bool enabled) { latching = enabled; }
+
+  /**
+   * @brief Update the mouse state to the latest motion, for latching
+   *
+   * It calls SDL_PumpEvents() if something is being dragged, so the events
+   * stay queued for the next frame. Without it, render() uses the mouse state
+   * of the last time the events were pumped.
+   */
+  void pumpLatch() const
+  {
+    if (latching && !eGrabbed.empty() && mLeftPressed) {
+      SDL_PumpEvents();
+    }
+  }
+
+  /// If the late latching is enabled
+  bool isLatching() const { return latching; }
+
+  /**
+   * @brief Set the time each frame should take to build and render
+   *
+   * If the frames take longer, the ui progressively does less work: it stops
+   * animations and the cursor blink, then replays memo() contents for some
+   * frames after their dependencies change and then also rebuilds the
+   * contents of idle scrollables that are clipped out only every few frames.
+   * @see getGovernor()
+   *
+   * @param microseconds the budget, if 0 (the default) it is never degraded
+   */
+  void setFrameBudget(Uint32 microseconds) { frameBudget = microseconds; }
+
+  /// The frame budget, in microseconds
+  Uint32 getFrameBudget() const { return frameBudget; }
+
+  /// The current decisions on how to fit in the frame budget
+  const Governor& getGovernor() const { return governor; }
+
+  /// If animations should run. It is false if over the frame budget
+  bool isAnimating() const { return governor.animating; }
+
+  /**
+   * @brief Animate a value
+   *
+   * It returns the value of the animation with the given id on this frame.
+   * When called with a different target, a new animation starts, from the
+   * current value to the new target. The first time it just returns target:
+   *
+   * ```
+   * double x = state.animate("x", open ? 200 : 0, 150);
+   * ```
+   *
+   * An animation that is not asked for on a frame is paused, until it is asked
+   * for again. While an animation runs, it requests an update to
+   * getUpdateTimeout(), unless the current group is clipped out, where it just
+   * jumps to the target. Over the frame budget, or if DUI_BOUNDED_MEMORY is
+   * defined, the target is always returned.
+   *
+   * @param id the animation id, on the current group
+   * @param target the value to animate to
+   * @param duration the duration in milliseconds
+   * @param easing the easing
+   * @return double the current value
+   */
+  double animate(std::string_view id,
+                 double target,
+                 Uint32 duration,
+                 Easing easing = Easing::EASE_OUT);
+
+  /**
+   * @brief Request a frame to be built at the given time
+   *
+   * Elements call this when they will change without input, like a blinking
+   * cursor. It is reset every frame.
+   *
+   * @param ticks when, in SDL_GetTicks() time
+   */
+  void scheduleUpdate(Uint32 ticks)
+  {
+    if (nextUpdate == NO_UPDATE || Sint32(ticks - nextUpdate) < 0) {
+      nextUpdate = ticks;
+    }
+  }
+
+  /**
+   * @brief Milliseconds until the ui needs a new frame with no input
+   *
+   * Use it to sleep until there is something to do:
+   *
+   * ```
+   * int timeout = state.getUpdateTimeout();
+   * if (timeout < 0 ? SDL_WaitEvent(&ev) : SDL_WaitEventTimeout(&ev, timeout))
+   * ```
+   *
+   * @return int the milliseconds, 0 if it must be now or -1 if never.
+   */
+  int getUpdateTimeout() const
+  {
+    if (nextUpdate == NO_UPDATE) {
+      return -1;
+    }
+    return std::max(Sint32(nextUpdate - SDL_GetTicks()), 0);
+  }
+
+  /**
+   * @brief The renderer, to create textures for elements
+   *
+   * Only on the thread that created this state, so not inside parallel()
+   * contents, as SDL renderers are not thread safe.
+   */
+  SDL_Renderer* getRenderer() const
+  {
+#ifndef DUI_BOUNDED_MEMORY
+    SDL_assert(!parentState && std::this_thread::get_id() == renderThread);
+#endif
+    return renderer;
+  }
+
   // These are experimental and should not be used
   void beginGroup(std::string_view id, const SDL_Rect& r);
   void endGroup(std::string_view id, const SDL_Rect& r);
   const Font& getFont() const { return font; }
   void setFont(const Font& f) { font = f; }
-  void pushLayer() { dList.incZ(); }
+  void pushLayer()
+  {
+    dList.incZ();
+    layerCount++;
+  }
   void popLayer() { dList.decZ(); }
+  int getLayerCount() const { return layerCount; }
+  DisplayList& getDisplayList() { return dList; }
+  MemoEntry* getMemo();
+  void touchGroup();
+  // If the fixed size groups being built leave nothing of the current visible
+  bool isClippedOut() const
+  {
+#ifdef DUI_BOUNDED_MEMORY
+    return false;
+#else
+    return visible.w <= 0 || visible.h <= 0;
+#endif
+  }
+  Uint32 getFrameCount() const { return frameCount; }
+  bool hasGroupInput(const SDL_Rect& r) const;
+  bool isGroupAnimating() const;
 
   int getWidth() { return width; }
   int getHeight() { return height; }
@@ -217,15 +839,83 @@ private:
     inFrame = true;
     lastMaxZIndex = dList.getMaxZIndex();
     dList.clear();
+    stats.droppedIds = 0;
+    for (int i = 0; i < INPUT_KINDS; ++i) {
+      if (!frameInput[i]) {
+        frameInput[i] = pendingInput[i];
+      }
+      pendingInput[i] = 0;
+    }
+#ifndef DUI_BOUNDED_MEMORY
+    wakePending.exchange(false);
+    stats.updates = updates.apply();
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    visible = {0, 0, width, height};
+    visibleStack.clear();
+#endif
+    frameCount++;
+#ifndef DUI_BOUNDED_MEMORY
+    for (auto it = jobs.begin(); it != jobs.end();) {
+      if (it->second.lastFrame + 1 < frameCount) {
+        it->second.control->cancel();
+        it = jobs.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (auto it = memos.begin(); it != memos.end();) {
+      if (it->second.lastFrame + 1 < frameCount) {
+        it = memos.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (auto it = geometries.begin(); it != geometries.end();) {
+      if (it->second.lastFrame + 1 < frameCount) {
+        it = geometries.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (auto it = textLines.begin(); it != textLines.end();) {
+      if (it->second.lastFrame + 1 < frameCount) {
+        it = textLines.erase(it);
+      } else {
+        ++it;
+      }
+    }
+#endif
     mHovering = false;
+    arena.reset();
     ticksCount = SDL_GetTicks();
+#ifndef DUI_BOUNDED_MEMORY
+    for (auto it = tweens.begin(); it != tweens.end();) {
+      auto& tween = it->second;
+      if (tween.lastFrame + 1 < frameCount &&
+          (tween.finished(tween.lastTicks) ||
+           tween.lastFrame + TWEEN_TIMEOUT < frameCount)) {
+        it = tweens.erase(it);
+      } else {
+        ++it;
+      }
+    }
+#endif
+    nextUpdate = NO_UPDATE;
+    buildStart = SDL_GetPerformanceCounter();
   }
 
   void endFrame()
   {
     SDL_assert(inFrame == true);
     inFrame = false;
+    dList.updateUsage();
+    stats.culledShapes = culling ? dList.cull() : 0;
+    stats.optimizedCommands = optimizing ? dList.optimize() : 0;
+    stats.droppedCommands = dList.getDropped();
+    buildTime = elapsedMicroseconds(buildStart, SDL_GetPerformanceCounter());
     tChanged = false;
+    tEditUsed = false;
+    mWheel = {0, 0};
     mGrabbing = false;
     if (mReleasing) {
       eGrabbed.clear();
@@ -235,10 +925,67 @@ private:
 
   bool isSameGroupId(std::string_view qualifiedId, std::string_view id) const;
 
+  SDL_Point latchDelta() const;
+
+  static Uint32 elapsedMicroseconds(Uint64 start, Uint64 end)
+  {
+    return Uint32((end - start) * 1000000 / SDL_GetPerformanceFrequency());
+  }
+
+  void stampInput(InputKind kind)
+  {
+    auto& timestamp = pendingInput[int(kind)];
+    if (!timestamp) {
+      // 0 means no input
+      timestamp = std::max(SDL_GetPerformanceCounter(), Uint64(1));
+    }
+  }
+
+  bool isInGroup(std::string_view qualifiedId) const
+  {
+    auto groupSize = group.size();
+    return qualifiedId.size() > groupSize &&
+           qualifiedId.substr(0, groupSize) == group &&
+           qualifiedId[groupSize] == groupNameSeparator;
+  }
+
+#ifndef DUI_BOUNDED_MEMORY
+  // On forks, the entry at hash on the closest ancestor having it, if this
+  // has none
+  template<class ENTRY>
+  const ENTRY* parentEntry(std::unordered_map<size_t, ENTRY> State::*cache,
+                           size_t hash) const
+  {
+    if (!parentState || (this->*cache).count(hash) != 0) {
+      return nullptr;
+    }
+    for (auto state = parentState; state; state = state->parentState) {
+      auto& entries = state->*cache;
+      auto it = entries.find(hash);
+      if (it != entries.end()) {
+        return &it->second;
+      }
+    }
+    return nullptr;
+  }
+
+  // The entry at hash to be changed. Forks copy it from the parent first
+  template<class ENTRY>
+  ENTRY& ownEntry(std::unordered_map<size_t, ENTRY> State::*cache, size_t hash)
+  {
+    auto& entries = this->*cache;
+    if (auto entry = parentEntry(cache, hash)) {
+      return entries.emplace(hash, *entry).first->second;
+    }
+    return entries[hash];
+  }
+#endif
+
   friend class Frame;
 };
 
-inline bool
+#ifdef DUI_DEFINITIONS
+DUI_INLINE bool
 State::isSameGroupId(std::string_view qualifiedId, std::string_view id) const
 {
   auto groupSize = group.size();
@@ -252,8 +999,418 @@ State::isSameGroupId(std::string_view qualifiedId, std::string_view id) const
   }
   return true;
 }
+#endif // DUI_DEFINITIONS
+
+#ifndef DUI_BOUNDED_MEMORY
+#ifdef DUI_DEFINITIONS
+DUI_INLINE State::State(const State& parent, Fork)
+  : inFrame(parent.inFrame)
+  , renderer(parent.renderer)
+  , dList(parent.dList.fork())
+  , lastMaxZIndex(parent.lastMaxZIndex)
+  , governor(parent.governor)
+  , mPos(parent.mPos)
+  , mWheel(parent.mWheel)
+  , mLeftPressed(parent.mLeftPressed)
+  , eGrabbed(parent.eGrabbed)
+  , mGrabOffset(parent.mGrabOffset)
+  , mHovering(parent.mHovering)
+  , mGrabbing(parent.mGrabbing)
+  , mReleasing(parent.mReleasing)
+  , eActive(parent.eActive)
+  , tEdit(parent.tEdit)
+  , tKeysym(parent.tKeysym)
+  , tChanged(parent.tChanged)
+  , tAction(parent.tAction)
+  , group(parent.group)
+  , droppedGroups(parent.droppedGroups)
+  , gGrabbed(parent.gGrabbed)
+  , gActive(parent.gActive)
+  , visible(parent.visible)
+  , visibleStack(parent.visibleStack)
+  , ticksCount(parent.ticksCount)
+  , frameCount(parent.frameCount)
+  , parentState(&parent)
+  , renderThread(parent.renderThread)
+  , font(parent.font)
+  , width(parent.width)
+  , height(parent.height)
+{
+  SDL_assert(inFrame);
+  SDL_memcpy(tBuffer, parent.tBuffer, sizeof(tBuffer));
+}
 
-inline MouseAction
+DUI_INLINE void
+State::join(State& fork)
+{
+  SDL_assert(inFrame && fork.inFrame);
+  dList.append(fork.dList);
+  stats.droppedIds += fork.stats.droppedIds;
+  layerCount += fork.layerCount;
+  if (fork.nextUpdate != NO_UPDATE) {
+    scheduleUpdate(fork.nextUpdate);
+  }
+  mHovering = mHovering || fork.mHovering;
+  mReleasing = mReleasing || fork.mReleasing;
+  if (mGrabbing) {
+    // Someone before already grabbed, so anything the fork did is void
+  } else if (fork.mGrabbing) {
+    eGrabbed = fork.eGrabbed;
+    mGrabOffset = fork.mGrabOffset;
+    eActive = fork.eActive;
+    mGrabbing = true;
+  } else if (fork.eActive.empty()) {
+    // The fork had the active element and it was clicked outside
+    eActive.clear();
+  }
+  // Only the fork building the active element uses its edit state
+  if (fork.tEditUsed && !eActive.empty() &&
+      std::string_view{eActive} == std::string_view{fork.eActive}) {
+    tEdit = fork.tEdit;
+    tEditUsed = true;
+  }
+  // The fork holds only the entries it used on this frame
+  for (auto& [hash, forkEntry] : fork.jobs) {
+    auto& entry = jobs[hash];
+    if (entry.control != forkEntry.control) {
+      if (entry.control) {
+        entry.control->cancel();
+      }
+      entry = std::move(forkEntry);
+    }
+    entry.lastFrame = frameCount;
+    if (entry.schedule && !parentState) {
+      entry.schedule(*this);
+      entry.schedule = nullptr;
+    }
+  }
+  for (auto& [hash, tween] : fork.tweens) {
+    tweens[hash] = std::move(tween);
+  }
+  // Unless an earlier one took the slot on this frame
+  for (auto& [hash, forkEntry] : fork.geometries) {
+    auto& entry = geometries[hash];
+    if (entry.lastFrame != frameCount) {
+      entry = std::move(forkEntry);
+    }
+  }
+  for (auto& [hash, forkEntry] : fork.textLines) {
+    auto& entry = textLines[hash];
+    if (entry.lastFrame != frameCount) {
+      entry = std::move(forkEntry);
+    }
+  }
+  // The ones read through, passed up if they came from further up
+  for (auto hash : fork.usedGeometries) {
+    auto it = geometries.find(hash);
+    if (it != geometries.end()) {
+      it->second.lastFrame = frameCount;
+    } else {
+      usedGeometries.push_back(hash);
+    }
+  }
+  for (auto hash : fork.usedTextLines) {
+    auto it = textLines.find(hash);
+    if (it != textLines.end()) {
+      it->second.lastFrame = frameCount;
+    } else {
+      usedTextLines.push_back(hash);
+    }
+  }
+}
+#endif // DUI_DEFINITIONS
+
+template<class FUNC>
+inline auto
+State::job(std::string_view id, FUNC work)
+  -> Job<std::invoke_result_t<FUNC&, JobControl&>>
+{
+  using T = std::invoke_result_t<FUNC&, JobControl&>;
+  static_assert(!std::is_void_v<T>, "The job must return its result");
+  auto hash = std::hash<std::string_view>{}(group) * 31 +
+              std::hash<std::string_view>{}(id);
+  auto& entry = ownEntry(&State::jobs, hash);
+  auto data = std::dynamic_pointer_cast<JobResult<T>>(entry.control);
+  if (!data || !isSameGroupId(entry.key, id)) {
+    if (entry.control) {
+      entry.control->cancel();
+    }
+    data = std::make_shared<JobResult<T>>();
+    entry.key = group;
+    entry.key += groupNameSeparator;
+    entry.key += id;
+    entry.control = data;
+    entry.schedule = [data, work = std::move(work)](State& state) {
+      state.getJobPool().submit([&state, data, work]() mutable {
+        if (data->isCancelled()) {
+          return;
+        }
+        data->value.emplace(work(*data));
+        if (!data->isCancelled()) {
+          state.post([data] { data->done = true; });
+        }
+      });
+    };
+    if (!parentState) {
+      entry.schedule(*this);
+      entry.schedule = nullptr;
+    }
+  }
+  entry.lastFrame = frameCount;
+  return {data};
+}
+#endif
+
+#ifndef DUI_BOUNDED_MEMORY
+#ifdef DUI_DEFINITIONS
+DUI_INLINE void
+State::post(std::function<void()> update)
+{
+  updates.post(std::move(update));
+  if (!wakePending.exchange(true) && wakeEvent != Uint32(-1)) {
+    SDL_Event ev{};
+    ev.type = wakeEvent;
+    SDL_PushEvent(&ev);
+  }
+}
+#endif // DUI_DEFINITIONS
+#endif
+
+template<class FILL>
+inline const VertexBuffer&
+State::tessellate(std::initializer_list<Uint32> key,
+                  const SDL_Point* points,
+                  size_t count,
+                  FILL fill)
+{
+#ifdef DUI_BOUNDED_MEMORY
+  geometryScratch.clear();
+  fill(geometryScratch);
+  return geometryScratch;
+#else
+  auto sameKey = [&](const GeometryEntry& entry) {
+    auto& k = entry.key;
+    if (entry.points.size() != count ||
+        !std::equal(key.begin(), key.end(), k.begin(), k.end())) {
+      return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (entry.points[i].x != points[i].x - points[0].x ||
+          entry.points[i].y != points[i].y - points[0].y) {
+        return false;
+      }
+    }
+    return true;
+  };
+  size_t hash = count;
+  for (auto value : key) {
+    hash = hash * 31 + value;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    hash = hash * 31 + Uint32(points[i].x - points[0].x);
+    hash = hash * 31 + Uint32(points[i].y - points[0].y);
+  }
+  // On a collision the next hashes are tried, so shapes used on the same frame
+  // never evict each other
+  for (;; ++hash) {
+    if (auto parentEntry = this->parentEntry(&State::geometries, hash)) {
+      if (sameKey(*parentEntry)) {
+        usedGeometries.push_back(hash);
+        return parentEntry->vertices;
+      }
+      if (parentEntry->lastFrame == frameCount) {
+        continue;
+      }
+    }
+    auto& entry = geometries[hash];
+    bool same = sameKey(entry);
+    if (!same && entry.lastFrame == frameCount) {
+      continue;
+    }
+    entry.lastFrame = frameCount;
+    if (!same) {
+      entry.key.assign(key.begin(), key.end());
+      entry.points.resize(count);
+      for (size_t i = 0; i < count; ++i) {
+        entry.points[i] = {points[i].x - points[0].x,
+                           points[i].y - points[0].y};
+      }
+      entry.vertices.clear();
+      fill(entry.vertices);
+    }
+    return entry.vertices;
+  }
+#endif
+}
+
+template<class F>
+inline void
+State::forEachLine(std::string_view str, size_t columns, F f)
+{
+  SDL_assert(columns > 0);
+#ifdef DUI_BOUNDED_MEMORY
+  for (size_t start = 0; start < str.size();) {
+    auto line = nextLine(str, start, columns);
+    f(line);
+    start = line.next;
+  }
+#else
+  // Probed on collisions, like tessellate()
+  auto hash = std::hash<std::string_view>{}(str) * 31 + columns;
+  auto sameKey = [&](const TextLinesEntry& entry) {
+    return entry.columns == columns && entry.text == str;
+  };
+  for (;; ++hash) {
+    if (auto parentEntry = this->parentEntry(&State::textLines, hash)) {
+      if (sameKey(*parentEntry)) {
+        usedTextLines.push_back(hash);
+        for (auto& line : parentEntry->lines) {
+          f(line);
+        }
+        return;
+      }
+      if (parentEntry->lastFrame == frameCount) {
+        continue;
+      }
+    }
+    auto& entry = textLines[hash];
+    bool same = sameKey(entry);
+    if (!same && entry.lastFrame == frameCount) {
+      continue;
+    }
+    entry.lastFrame = frameCount;
+    if (!same) {
+      entry.text = str;
+      entry.columns = columns;
+      entry.lines.clear();
+      for (size_t start = 0; start < str.size();) {
+        entry.lines.push_back(nextLine(str, start, columns));
+        start = entry.lines.back().next;
+      }
+    }
+    for (auto& line : entry.lines) {
+      f(line);
+    }
+    return;
+  }
+#endif
+}
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE MemoEntry*
+State::getMemo()
+{
+#ifdef DUI_BOUNDED_MEMORY
+  return nullptr;
+#else
+  std::string_view key{group};
+  auto& entry = memos[std::hash<std::string_view>{}(key)];
+  if (entry.key != key) {
+    entry.key = key;
+    entry.valid = false;
+  }
+  entry.lastFrame = frameCount;
+  return &entry;
+#endif
+}
+
+// The content of the current group is replayed instead of built, so what it
+// used must be kept as if it was used on this frame
+DUI_INLINE void
+State::touchGroup()
+{
+#ifndef DUI_BOUNDED_MEMORY
+  for (auto& [hash, entry] : jobs) {
+    if (isInGroup(entry.key)) {
+      entry.lastFrame = frameCount;
+    }
+  }
+  for (auto& [hash, tween] : tweens) {
+    if (isInGroup(tween.key)) {
+      tween.lastFrame = frameCount;
+      tween.lastTicks = ticksCount;
+    }
+  }
+  for (auto& [hash, entry] : memos) {
+    if (isInGroup(entry.key)) {
+      entry.lastFrame = frameCount;
+    }
+  }
+#endif
+}
+
+DUI_INLINE double
+State::animate(std::string_view id,
+               double target,
+               Uint32 duration,
+               Easing easing)
+{
+#ifdef DUI_BOUNDED_MEMORY
+  return target;
+#else
+  auto hash = std::hash<std::string_view>{}(group) * 31 +
+              std::hash<std::string_view>{}(id);
+  auto& tween = ownEntry(&State::tweens, hash);
+  if (!isSameGroupId(tween.key, id)) {
+    tween.key = group;
+    tween.key += groupNameSeparator;
+    tween.key += id;
+    tween.from = tween.to = target;
+    tween.start = ticksCount;
+    tween.duration = 0;
+  } else if (tween.lastFrame + 1 < frameCount) {
+    // It was paused, so resume from where it was
+    tween.start += ticksCount - tween.lastTicks;
+  }
+  tween.lastFrame = frameCount;
+  tween.lastTicks = ticksCount;
+  if (!governor.animating || isClippedOut()) {
+    // Nobody would see it moving
+    tween.from = tween.to = target;
+    tween.duration = 0;
+    return target;
+  }
+  if (tween.to != target) {
+    tween.from = tween.valueAt(ticksCount);
+    tween.to = target;
+    tween.start = ticksCount;
+    tween.duration = duration;
+    tween.easing = easing;
+  }
+  if (tween.finished(ticksCount)) {
+    return target;
+  }
+  scheduleUpdate(ticksCount);
+  return tween.valueAt(ticksCount);
+#endif
+}
+
+DUI_INLINE bool
+State::hasGroupInput(const SDL_Rect& r) const
+{
+  if ((mLeftPressed || mWheel.x != 0 || mWheel.y != 0) &&
+      SDL_PointInRect(&mPos, &r)) {
+    return true;
+  }
+  return isInGroup(eGrabbed) || isInGroup(eActive);
+}
+
+// If an animation on the current group has not reached its target, so its
+// content changes even if nothing else does
+DUI_INLINE bool
+State::isGroupAnimating() const
+{
+#ifndef DUI_BOUNDED_MEMORY
+  for (auto& [hash, tween] : tweens) {
+    if (isInGroup(tween.key) && !tween.finished(ticksCount)) {
+      return true;
+    }
+  }
+#endif
+  return false;
+}
+
+DUI_INLINE MouseAction
 State::checkMouse(std::string_view id, SDL_Rect r)
 {
   SDL_assert(inFrame);
@@ -262,6 +1419,10 @@ State::checkMouse(std::string_view id, SDL_Rect r)
       return MouseAction::NONE;
     }
     if (SDL_PointInRect(&mPos, &r) && !mGrabbing) {
+      if (group.size() + id.size() + 1 > eGrabbed.max_size()) {
+        stats.droppedIds++;
+        return MouseAction::NONE;
+      }
       eGrabbed = group;
       eGrabbed += groupNameSeparator;
       eGrabbed += id;
@@ -271,6 +1432,7 @@ State::checkMouse(std::string_view id, SDL_Rect r)
       gGrabbed = true;
       gActive = true;
       mGrabbing = true;
+      mGrabOffset = {mPos.x - r.x, mPos.y - r.y};
       return MouseAction::GRAB;
     }
     if (isSameGroupId(eActive, id)) {
@@ -298,15 +1460,35 @@ State::checkMouse(std::string_view id, SDL_Rect r)
   return MouseAction::ACTION;
 }
 
-inline void
+DUI_INLINE void
 State::beginGroup(std::string_view id, const SDL_Rect& r)
 {
   dList.popClip();
+#ifndef DUI_BOUNDED_MEMORY
+  visibleStack.push_back(visible);
+  // Auto sized sides are not known yet, so they do not clip
+  if (r.w > 0) {
+    int right = std::min(visible.x + visible.w, r.x + r.w);
+    visible.x = std::max(visible.x, r.x);
+    visible.w = right - visible.x;
+  }
+  if (r.h > 0) {
+    int bottom = std::min(visible.y + visible.h, r.y + r.h);
+    visible.y = std::max(visible.y, r.y);
+    visible.h = bottom - visible.y;
+  }
+#endif
   if (id.empty()) {
     return;
   }
   auto idSize = id.size();
   auto groupSize = group.size();
+  if (droppedGroups > 0 || groupSize + idSize + 1 > group.max_size()) {
+    // It behaves as an anonymous group
+    droppedGroups++;
+    stats.droppedIds++;
+    return;
+  }
   if (groupSize > 0) {
     group += groupNameSeparator;
     if (!gGrabbed || eGrabbed.size() <= idSize + groupSize + 1 ||
@@ -338,11 +1520,13 @@ State::beginGroup(std::string_view id, const SDL_Rect& r)
   group += id;
 }
 
-inline void
+DUI_INLINE void
 State::endGroup(std::string_view id, const SDL_Rect& r)
 {
   if (id.empty()) {
     // Nothing to do
+  } else if (droppedGroups > 0) {
+    droppedGroups--;
   } else if (id.size() >= group.size()) {
     // A top level group
     SDL_assert(group == id);
@@ -357,7 +1541,7 @@ State::endGroup(std::string_view id, const SDL_Rect& r)
     SDL_assert(group[nextSize] == groupNameSeparator);
     SDL_assert(std::string_view{group}.substr(nextSize + 1) == id);
 
-    group.erase(group.begin() + nextSize, group.end());
+    group.resize(nextSize);
     if (!gGrabbed && eGrabbed.size() > nextSize &&
         std::string_view{eGrabbed}.substr(0, nextSize) == group &&
         eGrabbed[nextSize] == groupNameSeparator) {
@@ -370,27 +1554,79 @@ State::endGroup(std::string_view id, const SDL_Rect& r)
     }
   }
   dList.pushClip(r);
+#ifndef DUI_BOUNDED_MEMORY
+  if (!visibleStack.empty()) {
+    visible = visibleStack.back();
+    visibleStack.pop_back();
+  }
+#endif
 }
 
-inline void
+DUI_INLINE SDL_Point
+State::latchDelta() const
+{
+  if (!latching || eGrabbed.empty() || !mLeftPressed) {
+    return {0, 0};
+  }
+  // The events are in the logical space, while the mouse state is in window
+  // coordinates
+  int logicalW, logicalH;
+  SDL_RenderGetLogicalSize(renderer, &logicalW, &logicalH);
+  float scaleX, scaleY;
+  SDL_RenderGetScale(renderer, &scaleX, &scaleY);
+  if (logicalW != 0 || scaleX != 1.f || scaleY != 1.f) {
+    return {0, 0};
+  }
+  // Released after the last event handled, so it is not dragged anymore
+  SDL_Point now;
+  if (!(SDL_GetMouseState(&now.x, &now.y) & SDL_BUTTON_LMASK)) {
+    return {0, 0};
+  }
+  return {now.x - mPos.x, now.y - mPos.y};
+}
+
+DUI_INLINE void
+State::present()
+{
+  SDL_assert(!inFrame);
+  SDL_RenderPresent(renderer);
+  auto now = SDL_GetPerformanceCounter();
+  for (int i = 0; i < INPUT_KINDS; ++i) {
+    if (frameInput[i]) {
+      latencies[i].add(elapsedMicroseconds(frameInput[i], now));
+      frameInput[i] = 0;
+    }
+  }
+}
+
+DUI_INLINE void
 State::event(SDL_Event& ev)
 {
   if (ev.type == SDL_MOUSEBUTTONDOWN) {
+    stampInput(InputKind::MOUSE_BUTTON);
     mPos = {ev.button.x, ev.button.y};
     if (ev.button.button == SDL_BUTTON_LEFT) {
       mLeftPressed = true;
     }
   } else if (ev.type == SDL_MOUSEMOTION) {
+    stampInput(InputKind::MOUSE_MOTION);
     if (!(eGrabbed.empty() && mLeftPressed)) {
       mPos = {ev.motion.x, ev.motion.y};
     }
   } else if (ev.type == SDL_MOUSEBUTTONUP) {
+    stampInput(InputKind::MOUSE_BUTTON);
     mPos = {ev.button.x, ev.button.y};
     mLeftPressed = false;
+  } else if (ev.type == SDL_MOUSEWHEEL) {
+    stampInput(InputKind::MOUSE_MOTION);
+    int sign = ev.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -1 : 1;
+    mWheel.x += ev.wheel.x * sign;
+    mWheel.y += ev.wheel.y * sign;
   } else if (ev.type == SDL_TEXTINPUT) {
     if (eActive.empty()) {
       return;
     }
+    stampInput(InputKind::TEXT);
     for (int i = 0, j = 0; i < SDL_TEXTINPUTEVENT_TEXT_SIZE; ++i) {
       tBuffer[j] = ev.text.text[i];
       if (tBuffer[j] == 0) {
@@ -408,6 +1644,7 @@ State::event(SDL_Event& ev)
     tChanged = true;
     tAction = TextAction::INPUT;
   } else if (ev.type == SDL_KEYDOWN) {
+    stampInput(InputKind::KEY);
     if (!tChanged) {
       tKeysym = ev.key.keysym;
       tChanged = true;
@@ -415,6 +1652,7 @@ State::event(SDL_Event& ev)
     }
   }
 }
+#endif // DUI_DEFINITIONS
 } // namespace dui
 
 #endif // DUI_STATE_HPP_
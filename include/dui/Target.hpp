@@ -66,6 +66,19 @@ public:
    */
   MouseAction checkMouse(std::string_view id, SDL_Rect r);
 
+  /**
+   * @brief Check if the mouse is over an element with nothing on top
+   *
+   * @param r the element local rect (Use State.isHovered() for global rect)
+   */
+  bool isHovered(SDL_Rect r) const
+  {
+    SDL_Point caret = getCaret();
+    r.x += caret.x;
+    r.y += caret.y;
+    return state->isHovered(r);
+  }
+
   /**
    * @brief Check if given contained element is active
    *
@@ -197,6 +210,13 @@ public:
   /// Get the height currently occupied by elements contained in this group
   int contentHeight() const { return bottomRight->y - topLeft->y; }
 
+  /// To be used internally. Set the size occupied by elements
+  void setContentSize(const SDL_Point& sz)
+  {
+    bottomRight->x = topLeft->x + sz.x;
+    bottomRight->y = topLeft->y + sz.y;
+  }
+
   /// To be used internally
   void lock(std::string_view id, SDL_Rect r)
   {
@@ -223,7 +243,8 @@ public:
   operator bool() const { return state; }
 };
 
-inline MouseAction
+#ifdef DUI_DEFINITIONS
+DUI_INLINE MouseAction
 Target::checkMouse(std::string_view id, SDL_Rect r)
 {
   SDL_assert(!*locked);
@@ -233,7 +254,7 @@ Target::checkMouse(std::string_view id, SDL_Rect r)
   return state->checkMouse(id, r);
 }
 
-inline void
+DUI_INLINE void
 Target::advance(const SDL_Point& p)
 {
   SDL_assert(!*locked);
@@ -248,6 +269,7 @@ Target::advance(const SDL_Point& p)
     bottomRight->y = std::max(p.y + topLeft->y, bottomRight->y);
   }
 }
+#endif // DUI_DEFINITIONS
 
 /// Helper class to generate the accessors you get on Target on a Group class
 /// The group class must at least have a convert operator to Target
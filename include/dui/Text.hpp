@@ -1,6 +1,7 @@
 #ifndef DUI_TEXT_HPP_
 #define DUI_TEXT_HPP_
 
+#include <algorithm>
 #include <SDL.h>
 #include "Group.hpp"
 #include "TextStyle.hpp"
@@ -56,6 +57,36 @@ character(Target target,
   state.display(Shape::Texture(dstRect, font.texture, srcRect, style.color));
 }
 
+/**
+ * @brief Display a text on the given global position
+ *
+ * It neither checks nor advances any target. You probably want text() instead.
+ *
+ * @param state the state
+ * @param str the text
+ * @param p the global position
+ * @param font the font, with a texture
+ * @param style
+ */
+inline void
+displayText(State& state,
+            std::string_view str,
+            const SDL_Point& p,
+            const Font& font,
+            const TextStyle& style)
+{
+  SDL_Rect dstRect{
+    p.x, p.y, font.charW << style.scale, font.charH << style.scale};
+  for (auto ch : str) {
+    SDL_Rect srcRect{(ch % font.cols) * font.charW,
+                     (ch / font.cols) * font.charH,
+                     font.charW,
+                     font.charH};
+    state.display(Shape::Texture(dstRect, font.texture, srcRect, style.color));
+    dstRect.x += dstRect.w;
+  }
+}
+
 /**
  * @brief Adds a text element
  * @ingroup elements
@@ -78,20 +109,101 @@ text(Target target,
   SDL_assert(font.texture != nullptr);
 
   auto caret = target.getCaret();
-  SDL_Rect dstRect{p.x + caret.x,
-                   p.y + caret.y,
-                   font.charW << style.scale,
-                   font.charH << style.scale};
-  target.advance({p.x + dstRect.w * int(str.size()), p.y + dstRect.h});
-  for (auto ch : str) {
-    SDL_Rect srcRect{(ch % font.cols) * font.charW,
-                     (ch / font.cols) * font.charH,
-                     font.charW,
-                     font.charH};
-    state.display(Shape::Texture(dstRect, font.texture, srcRect, style.color));
-    dstRect.x += dstRect.w;
+  auto sz = measure(str, font, style.scale);
+  target.advance({p.x + sz.x, p.y + sz.y});
+  displayText(state, str, {p.x + caret.x, p.y + caret.y}, font, style);
+}
+
+/**
+ * @brief Adds a text element formatted from the given arguments
+ * @ingroup elements
+ *
+ * The text is formatted on State memory, with no allocations once it is warm.
+ * @see State.format()
+ *
+ * @param target the parent group or frame
+ * @param p the position
+ * @param fmt the format, with a "{}" for each argument
+ * @param args the arguments
+ */
+template<class... ARGS>
+inline void
+textf(Target target,
+      const SDL_Point& p,
+      std::string_view fmt,
+      const ARGS&... args)
+{
+  text(target, target.getState().format(fmt, args...), p);
+}
+
+/**
+ * @brief Adds a text element broken into lines that fit the given width
+ * @ingroup elements
+ *
+ * @param target the parent group or frame
+ * @param str the text
+ * @param p the position
+ * @param width the max width. If 0, the target width after p is used. If
+ * there is no width, the text is not broken, except on new lines.
+ * @param style
+ * @return int the number of lines
+ */
+inline int
+wrappedText(Target target,
+            std::string_view str,
+            const SDL_Point& p,
+            int width = 0,
+            const TextStyle& style = themeFor<Text>())
+{
+  auto& state = target.getState();
+  auto& font = style.font.texture ? style.font : state.getFont();
+  if (width == 0) {
+    width = target.width() - p.x;
+  }
+  auto charSize = measure('X', font, style.scale);
+  size_t columns = width > 0 ? std::max(width / charSize.x, 1) : str.size();
+  int lines = 0;
+  state.forEachLine(str, std::max(columns, size_t(1)), [&](TextLine line) {
+    auto part = str.substr(line.begin, line.end - line.begin);
+    text(target, part, {p.x, p.y + lines * charSize.y}, style);
+    lines++;
+  });
+  return lines;
+}
+
+/**
+ * @brief Adds a text element cut to fit the given width, ending in "..."
+ * @ingroup elements
+ *
+ * @param target the parent group or frame
+ * @param str the text
+ * @param p the position
+ * @param width the max width. If 0, the target width after p is used
+ * @param style
+ */
+inline void
+ellipsizedText(Target target,
+               std::string_view str,
+               const SDL_Point& p,
+               int width = 0,
+               const TextStyle& style = themeFor<Text>())
+{
+  auto& font = style.font.texture ? style.font : target.getState().getFont();
+  if (width == 0) {
+    width = target.width() - p.x;
   }
+  int columns = std::max(width / measure('X', font, style.scale).x, 0);
+  if (width <= 0 || str.size() <= size_t(columns)) {
+    text(target, str, p, style);
+    return;
+  }
+  constexpr std::string_view ellipsis = "...";
+  int kept = std::max(columns - int(ellipsis.size()), 0);
+  text(target, str.substr(0, kept), p, style);
+  auto dotsX = p.x + measure(str.substr(0, kept), font, style.scale).x;
+  text(target, ellipsis.substr(0, columns - kept), {dotsX, p.y}, style);
 }
+
 } // namespace dui
 
 #endif // DUI_TEXT_HPP_
@@ -30,6 +30,26 @@ themeFor()
   return style::FromTheme<Element, Theme>::get();
 }
 
+/**
+ * @brief A style known at compile time
+ *
+ * Elements taking it instead of a style value leave out, at compile time, the
+ * decorations the style makes invisible, like zero width borders and
+ * transparent backgrounds.
+ *
+ * @tparam SOURCE a type with a static constexpr get() returning the style, like
+ * the style::FromTheme specializations
+ */
+template<class SOURCE>
+struct StaticStyle
+{
+  static constexpr auto get() { return SOURCE::get(); }
+};
+
+/// The style of the given element and theme, as a StaticStyle
+template<class Element, class Theme = DUI_THEME>
+constexpr StaticStyle<style::FromTheme<Element, Theme>> staticThemeFor{};
+
 } // namespace dui
 
 #endif // DUI_THEME_HPP_
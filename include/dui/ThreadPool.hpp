@@ -0,0 +1,159 @@
+#ifndef DUI_THREADPOOL_HPP_
+#define DUI_THREADPOOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Config.hpp"
+
+namespace dui {
+
+/**
+ * @brief A fixed set of worker threads running submitted jobs
+ *
+ */
+class ThreadPool
+{
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> jobs;
+  std::mutex mutex;
+  std::condition_variable wakeUp;
+  bool stopping = false;
+
+  void work();
+
+public:
+  /**
+   * @brief Ctor
+   *
+   * @param count the number of worker threads. If 0, one less than the number
+   * of hardware threads is used, but at least one.
+   */
+  explicit ThreadPool(unsigned count = 0);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Dtor. Waits for the queued jobs
+  ~ThreadPool();
+
+  /// Number of worker threads
+  size_t size() const { return workers.size(); }
+
+  /// Queue a job to run on a worker thread
+  void submit(std::function<void()> job);
+
+  /**
+   * @brief Call func(i) for each i in [0, count), in parallel
+   *
+   * The calling thread also runs the function and it only returns when all
+   * calls are finished. The indices are claimed one at time by whoever is
+   * free, so the load is balanced even when some calls take much longer.
+   */
+  template<class FUNC>
+  void parallelFor(size_t count, FUNC func);
+};
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE ThreadPool::ThreadPool(unsigned count)
+{
+  if (count == 0) {
+    count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  }
+  workers.reserve(count);
+  for (unsigned i = 0; i < count; ++i) {
+    workers.emplace_back([this] { work(); });
+  }
+}
+
+DUI_INLINE ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    stopping = true;
+  }
+  wakeUp.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+DUI_INLINE void
+ThreadPool::submit(std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    jobs.push_back(std::move(job));
+  }
+  wakeUp.notify_one();
+}
+
+DUI_INLINE void
+ThreadPool::work()
+{
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock{mutex};
+      wakeUp.wait(lock, [this] { return stopping || !jobs.empty(); });
+      if (jobs.empty()) {
+        return;
+      }
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+    job();
+  }
+}
+#endif // DUI_DEFINITIONS
+
+template<class FUNC>
+inline void
+ThreadPool::parallelFor(size_t count, FUNC func)
+{
+  // The helpers might only run after we are done (if the workers are busy with
+  // other jobs), so everything they touch is kept alive by them
+  struct Control
+  {
+    std::function<void(size_t)> func;
+    size_t count;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    void run()
+    {
+      for (size_t i = next++; i < count; i = next++) {
+        func(i);
+        if (++done == count) {
+          std::lock_guard<std::mutex> lock{mutex};
+          finished.notify_all();
+        }
+      }
+    }
+  };
+  if (count == 0) {
+    return;
+  }
+  auto control = std::make_shared<Control>();
+  control->func = std::move(func);
+  control->count = count;
+  size_t helpers = std::min(count - 1, workers.size());
+  for (size_t i = 0; i < helpers; ++i) {
+    submit([control] { control->run(); });
+  }
+  control->run();
+  std::unique_lock<std::mutex> lock{control->mutex};
+  control->finished.wait(lock, [&] { return control->done == count; });
+}
+
+} // namespace dui
+
+#endif // DUI_THREADPOOL_HPP_
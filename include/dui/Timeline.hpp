@@ -0,0 +1,405 @@
+#ifndef DUI_TIMELINE_HPP_
+#define DUI_TIMELINE_HPP_
+
+#ifndef DUI_BOUNDED_MEMORY
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <SDL.h>
+#include "Box.hpp"
+#include "Group.hpp"
+#include "Text.hpp"
+#include "TimelineStyle.hpp"
+
+namespace dui {
+
+/// A span of a SpanTrace, or several merged ones on its coarser tiers
+struct TraceSpan
+{
+  Sint64 start; ///< The start time, on any unit
+  Sint64 end;   ///< The end time
+  Uint32 name;  ///< The name index, on SpanTrace.getName()
+  Uint32 count; ///< How many spans were merged on it
+};
+
+/**
+ * @brief Nested time spans, as shown by timeline()
+ *
+ * Besides the spans, each depth has tiers of coarser spans, each merging the
+ * close ones smaller than its resolution. Showing them only looks at the tier
+ * made for the zoom level, so the work is about the same for the whole trace
+ * or for a small part of it.
+ *
+ * Add all spans and then call build(). Building is linear on the number of
+ * spans for each tier, so for big traces it might be better done on a
+ * State.job().
+ */
+class SpanTrace
+{
+  struct Tier
+  {
+    Sint64 resolution; // Spans smaller than it might be merged
+    std::vector<TraceSpan> spans;
+  };
+
+  std::vector<std::string> names;
+  std::unordered_map<std::string, Uint32> nameIndices;
+  std::vector<std::vector<Tier>> depths; // The first tier has all spans
+  Sint64 start = 0;
+  Sint64 end = 0;
+
+  static constexpr Sint64 TIER_STEP = 4; // Resolution ratio between tiers
+
+  static void merge(const std::vector<TraceSpan>& spans,
+                    Sint64 resolution,
+                    std::vector<TraceSpan>& merged);
+
+public:
+  /// Add a name, returning its index. Equal names get the same index
+  Uint32 addName(std::string_view name);
+
+  /// The name with the given index
+  std::string_view getName(Uint32 index) const { return names[index]; }
+
+  /**
+   * @brief Add a span
+   *
+   * @param depth the nesting depth, from 0
+   * @param start the start time
+   * @param end the end time
+   * @param name the name index, from addName()
+   */
+  void addSpan(int depth, Sint64 start, Sint64 end, Uint32 name);
+
+  /**
+   * @brief Sort the spans and build the coarser tiers
+   *
+   * Spans on the same depth must not overlap.
+   */
+  void build();
+
+  /// Number of depths
+  int getDepthCount() const { return int(depths.size()); }
+
+  /// The start of the first span
+  Sint64 getStart() const { return start; }
+
+  /// The end of the last span
+  Sint64 getEnd() const { return end; }
+
+  /// All the spans on a depth, sorted by time after build()
+  const std::vector<TraceSpan>& getSpans(int depth) const
+  {
+    return depths[depth].front().spans;
+  }
+
+  /**
+   * @brief The coarsest spans on a depth that can be shown with a resolution
+   *
+   * @param depth the depth
+   * @param ticksPerPixel the time shown on each pixel
+   * @return const std::vector<TraceSpan>& the spans, where the ones merged
+   * are at most about a pixel wide.
+   */
+  const std::vector<TraceSpan>& getSpans(int depth, double ticksPerPixel) const;
+
+  /// The span on a depth containing a time, or nullptr if none
+  const TraceSpan* spanAt(int depth, Sint64 time) const;
+};
+
+/// The view and selection of a timeline()
+struct TimelineState
+{
+  double start = 0;         ///< The time on the left border
+  double ticksPerPixel = 0; ///< The zoom, if 0 the whole trace is shown
+  int scrollY = 0;          ///< Vertical scroll, in pixels
+  int selectedDepth = -1;   ///< The depth of the selected span, -1 if none
+  Sint64 selectedStart = 0; ///< The start of the selected span
+
+  // Used by timeline() between frames
+  double grabbedTime = 0;
+  int grabbedY = 0;
+  SDL_Point grabbedMouse{0, 0};
+
+  static constexpr double ZOOM_STEP = 1.25; ///< Per mouse wheel step
+  static constexpr int CLICK_SLOP = 2; ///< Max motion in pixels for a click
+};
+
+/**
+ * @brief A zoomable view of a SpanTrace, like a flame graph
+ * @ingroup elements
+ *
+ * Each depth is a row, where spans are boxes along the time. Dragging pans,
+ * the mouse wheel zooms around the mouse and clicking on a span selects it.
+ *
+ * At any zoom level, at most one box is drawn for each pixel column of each
+ * row, the spans too small to be seen on their own being merged on it. The
+ * span names are drawn only when they fit on the span.
+ *
+ * @param target the parent group or frame
+ * @param id the timeline id
+ * @param trace the trace, built
+ * @param view the timeline state, it must be kept between frames
+ * @param r the timeline position and size
+ * @param style
+ * @return true if a span was selected on this frame
+ */
+inline bool
+timeline(Target target,
+         std::string_view id,
+         const SpanTrace& trace,
+         TimelineState* view,
+         const SDL_Rect& r,
+         const TimelineStyle& style = themeFor<Timeline>())
+{
+  SDL_assert(view != nullptr);
+  auto g = group(target, id, r, Layout::NONE);
+  Target canvas = g;
+  SDL_Rect client{0, 0, r.w, r.h};
+  auto mouse = canvas.lastMousePos();
+  auto& spanStyle = style.span;
+  auto offset = spanStyle.padding + spanStyle.border;
+  int rowH =
+    elementSize(offset, measure('X', spanStyle.font, spanStyle.scale)).y;
+  int depthCount = trace.getDepthCount();
+  int maxScroll = std::max(depthCount * rowH - r.h, 0);
+  double duration = double(trace.getEnd() - trace.getStart());
+  double maxTicksPerPixel = std::max(duration, 1.0) / std::max(r.w, 1);
+  constexpr double MIN_TICKS_PER_PIXEL = 1.0 / 64;
+  if (view->ticksPerPixel <= 0) {
+    view->start = double(trace.getStart());
+    view->ticksPerPixel = maxTicksPerPixel;
+  }
+
+  bool selected = false;
+  auto action = canvas.checkMouse("canvas", client);
+  if (action == MouseAction::GRAB) {
+    view->grabbedTime = view->start + mouse.x * view->ticksPerPixel;
+    view->grabbedY = view->scrollY + mouse.y;
+    view->grabbedMouse = mouse;
+  } else if (action == MouseAction::HOLD || action == MouseAction::DRAG) {
+    view->start = view->grabbedTime - mouse.x * view->ticksPerPixel;
+    view->scrollY = std::clamp(view->grabbedY - mouse.y, 0, maxScroll);
+  } else if (action == MouseAction::ACTION &&
+             std::abs(mouse.x - view->grabbedMouse.x) <= view->CLICK_SLOP &&
+             std::abs(mouse.y - view->grabbedMouse.y) <= view->CLICK_SLOP) {
+    int depth = (view->scrollY + mouse.y) / rowH;
+    auto time = Sint64(std::floor(view->start + mouse.x * view->ticksPerPixel));
+    auto span = depth < depthCount ? trace.spanAt(depth, time) : nullptr;
+    if (span) {
+      view->selectedDepth = depth;
+      view->selectedStart = span->start;
+      selected = true;
+    } else {
+      view->selectedDepth = -1;
+    }
+  }
+  auto wheel = canvas.getState().lastWheel();
+  if (wheel.y != 0 && canvas.isHovered(client)) {
+    // Zoom around the mouse
+    double time = view->start + mouse.x * view->ticksPerPixel;
+    view->ticksPerPixel = std::clamp(
+      view->ticksPerPixel * std::pow(view->ZOOM_STEP, -wheel.y),
+      MIN_TICKS_PER_PIXEL,
+      maxTicksPerPixel);
+    view->start = time - mouse.x * view->ticksPerPixel;
+  }
+  view->scrollY = std::clamp(view->scrollY, 0, maxScroll);
+
+  double ticksPerPixel = view->ticksPerPixel;
+  double viewStart = view->start;
+  double viewEnd = viewStart + r.w * ticksPerPixel;
+  auto spanColor = [&](const TraceSpan& span) {
+    // Neighbor names get slightly different shades
+    auto c = spanStyle.paint.background;
+    int shade = int(span.name % 4) * 12;
+    return SDL_Color{Uint8(std::max(c.r - shade, 0)),
+                     Uint8(std::max(c.g - shade, 0)),
+                     Uint8(std::max(c.b - shade, 0)),
+                     c.a};
+  };
+  int firstDepth = view->scrollY / rowH;
+  int lastDepth = std::min((view->scrollY + r.h) / rowH + 1, depthCount);
+  for (int depth = firstDepth; depth < lastDepth; ++depth) {
+    int y = depth * rowH - view->scrollY;
+    auto& spans = trace.getSpans(depth, ticksPerPixel);
+    auto it = std::upper_bound(
+      spans.begin(),
+      spans.end(),
+      viewStart,
+      [](double time, const TraceSpan& span) { return time < span.end; });
+
+    // The box being grown, drawn once the next span is on another column
+    const TraceSpan* boxSpan = nullptr;
+    int x0 = 0;
+    int x1 = 0;
+    bool merged = false;
+    auto draw = [&] {
+      SDL_Rect rect{x0, y, x1 - x0, rowH - 1};
+      if (merged || boxSpan->count > 1) {
+        colorBox(canvas, rect, style.merged);
+        return;
+      }
+      auto name = trace.getName(boxSpan->name);
+      int left = std::max(x0, 0);
+      int width = std::min(x1, r.w) - left;
+      if (measure(name, spanStyle.font, spanStyle.scale).x + offset.left +
+            offset.right <=
+          width) {
+        text(canvas, name, {left + offset.left, y + offset.top}, spanStyle);
+      }
+      bool isSelected = depth == view->selectedDepth &&
+                        boxSpan->start == view->selectedStart;
+      colorBox(canvas, rect, isSelected ? style.selected : spanColor(*boxSpan));
+    };
+    for (; it != spans.end() && it->start < viewEnd; ++it) {
+      // Clamped before converting, as zoomed in they can be out of int range
+      int spanX0 = int(std::clamp(
+        std::floor((it->start - viewStart) / ticksPerPixel), -1.0, r.w + 1.0));
+      int spanX1 = int(std::clamp(
+        std::ceil((it->end - viewStart) / ticksPerPixel), -1.0, r.w + 1.0));
+      spanX1 = std::max(spanX1, spanX0 + 1);
+      if (boxSpan && spanX0 < x1) {
+        x1 = std::max(x1, spanX1);
+        merged = true;
+        continue;
+      }
+      if (boxSpan) {
+        draw();
+      }
+      boxSpan = &*it;
+      x0 = spanX0;
+      x1 = spanX1;
+      merged = false;
+    }
+    if (boxSpan) {
+      draw();
+    }
+  }
+  colorBox(canvas, client, style.background);
+  return selected;
+}
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE Uint32
+SpanTrace::addName(std::string_view name)
+{
+  std::string key{name};
+  auto it = nameIndices.find(key);
+  if (it != nameIndices.end()) {
+    return it->second;
+  }
+  auto index = Uint32(names.size());
+  names.push_back(key);
+  nameIndices.emplace(std::move(key), index);
+  return index;
+}
+
+DUI_INLINE void
+SpanTrace::addSpan(int depth, Sint64 start, Sint64 end, Uint32 name)
+{
+  SDL_assert(depth >= 0 && start <= end && name < names.size());
+  if (depth >= int(depths.size())) {
+    depths.resize(depth + 1, {{0, {}}});
+  }
+  depths[depth].front().spans.push_back({start, end, name, 1});
+}
+
+DUI_INLINE void
+SpanTrace::build()
+{
+  bool first = true;
+  for (auto& tiers : depths) {
+    tiers.resize(1);
+    auto& spans = tiers.front().spans;
+    auto earlier = [](const TraceSpan& a, const TraceSpan& b) {
+      return a.start < b.start;
+    };
+    if (!std::is_sorted(spans.begin(), spans.end(), earlier)) {
+      std::sort(spans.begin(), spans.end(), earlier);
+    }
+    if (spans.empty()) {
+      continue;
+    }
+    if (first) {
+      start = spans.front().start;
+      end = spans.back().end;
+      first = false;
+    } else {
+      start = std::min(start, spans.front().start);
+      end = std::max(end, spans.back().end);
+    }
+  }
+
+  // A tier is kept only if it has at most half the spans of the last one
+  std::vector<TraceSpan> merged;
+  for (auto& tiers : depths) {
+    for (Sint64 resolution = TIER_STEP; tiers.back().spans.size() > 1 &&
+                                        resolution / TIER_STEP <= end - start;
+         resolution *= TIER_STEP) {
+      auto& last = tiers.back().spans;
+      merge(last, resolution, merged);
+      if (merged.size() * 2 <= last.size()) {
+        tiers.push_back({resolution, merged});
+      }
+    }
+  }
+}
+
+DUI_INLINE void
+SpanTrace::merge(const std::vector<TraceSpan>& spans,
+                 Sint64 resolution,
+                 std::vector<TraceSpan>& merged)
+{
+  // Close spans are merged while the result is at most two resolutions long
+  merged.clear();
+  for (auto& span : spans) {
+    if (!merged.empty()) {
+      auto& last = merged.back();
+      if (span.start - last.end < resolution &&
+          span.end - last.start <= 2 * resolution) {
+        last.end = span.end;
+        last.count += span.count;
+        continue;
+      }
+    }
+    merged.push_back(span);
+  }
+}
+
+DUI_INLINE const std::vector<TraceSpan>&
+SpanTrace::getSpans(int depth, double ticksPerPixel) const
+{
+  auto& tiers = depths[depth];
+  size_t i = 0;
+  while (i + 1 < tiers.size() && tiers[i + 1].resolution <= ticksPerPixel) {
+    ++i;
+  }
+  return tiers[i].spans;
+}
+
+DUI_INLINE const TraceSpan*
+SpanTrace::spanAt(int depth, Sint64 time) const
+{
+  auto& spans = getSpans(depth);
+  auto it = std::upper_bound(
+    spans.begin(), spans.end(), time, [](Sint64 time, const TraceSpan& span) {
+      return time < span.start;
+    });
+  if (it == spans.begin()) {
+    return nullptr;
+  }
+  --it;
+  return time < it->end ? &*it : nullptr;
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_BOUNDED_MEMORY
+
+#endif // DUI_TIMELINE_HPP_
@@ -0,0 +1,63 @@
+#ifndef DUI_TIMELINESTYLE_HPP_
+#define DUI_TIMELINESTYLE_HPP_
+
+#include <SDL.h>
+#include "BoxStyle.hpp"
+#include "ButtonStyle.hpp"
+#include "ElementStyle.hpp"
+#include "Theme.hpp"
+
+namespace dui {
+
+// Style for timeline
+struct TimelineStyle
+{
+  SDL_Color background;
+  ElementStyle span;
+  SDL_Color merged;
+  SDL_Color selected;
+
+  constexpr TimelineStyle withBackground(SDL_Color background) const
+  {
+    return {background, span, merged, selected};
+  }
+  constexpr TimelineStyle withSpan(const ElementStyle& span) const
+  {
+    return {background, span, merged, selected};
+  }
+  constexpr TimelineStyle withMerged(SDL_Color merged) const
+  {
+    return {background, span, merged, selected};
+  }
+  constexpr TimelineStyle withSelected(SDL_Color selected) const
+  {
+    return {background, span, merged, selected};
+  }
+};
+
+struct Timeline;
+
+namespace style {
+
+template<class Theme>
+struct FromTheme<Timeline, Theme>
+{
+  constexpr static TimelineStyle get()
+  {
+    auto box = themeFor<Box, Theme>();
+    auto button = themeFor<ButtonBase, Theme>();
+    return {
+      box.paint.background,
+      themeFor<Element, Theme>()
+        .withPadding(EdgeSize::all(1))
+        .withBackgroundColor(button.normal.background),
+      button.grabbed.background,
+      box.paint.border.left,
+    };
+  }
+};
+} // namespace style
+
+} // namespace dui
+
+#endif // DUI_TIMELINESTYLE_HPP_
@@ -0,0 +1,117 @@
+#ifndef DUI_UPDATEQUEUE_HPP_
+#define DUI_UPDATEQUEUE_HPP_
+
+#include <atomic>
+#include <functional>
+#include "Config.hpp"
+
+namespace dui {
+
+/**
+ * @brief Queue of updates posted by many threads and applied by one
+ *
+ * Posting never blocks nor waits for other posters, it is a single atomic
+ * exchange. Applying is done by a single consumer thread and never waits
+ * either: an update whose post is still in progress is left for the next
+ * apply() call.
+ */
+class UpdateQueue
+{
+  struct Node
+  {
+    std::atomic<Node*> next{nullptr};
+    std::function<void()> update;
+  };
+
+  std::atomic<Node*> head; // Last posted, written by producers
+  Node* tail;              // Next to apply, owned by the consumer
+  Node stub;
+
+  void link(Node* node)
+  {
+    auto prev = head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  Node* pop();
+
+public:
+  UpdateQueue()
+    : head(&stub)
+    , tail(&stub)
+  {}
+
+  UpdateQueue(const UpdateQueue&) = delete;
+  UpdateQueue& operator=(const UpdateQueue&) = delete;
+
+  /// Dtor. Discards the updates not applied
+  ~UpdateQueue()
+  {
+    while (auto node = pop()) {
+      delete node;
+    }
+  }
+
+  /// Post an update, it can be called from any thread
+  void post(std::function<void()> update)
+  {
+    auto node = new Node;
+    node->update = std::move(update);
+    link(node);
+  }
+
+  /**
+   * @brief Call all completely posted updates, in order
+   *
+   * It must be called always from the same thread.
+   *
+   * @return int the number of applied updates
+   */
+  int apply()
+  {
+    int count = 0;
+    while (auto node = pop()) {
+      node->update();
+      delete node;
+      count++;
+    }
+    return count;
+  }
+};
+
+#ifdef DUI_DEFINITIONS
+DUI_INLINE UpdateQueue::Node*
+UpdateQueue::pop()
+{
+  auto first = tail;
+  auto next = first->next.load(std::memory_order_acquire);
+  if (first == &stub) {
+    if (!next) {
+      return nullptr;
+    }
+    tail = first = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  if (next) {
+    tail = next;
+    return first;
+  }
+  if (first != head.load(std::memory_order_acquire)) {
+    // A post is halfway, its node is not linked yet
+    return nullptr;
+  }
+  // first is the last one, put the stub behind it so it can be detached
+  stub.next.store(nullptr, std::memory_order_relaxed);
+  link(&stub);
+  next = first->next.load(std::memory_order_acquire);
+  if (next) {
+    tail = next;
+    return first;
+  }
+  return nullptr;
+}
+#endif // DUI_DEFINITIONS
+
+} // namespace dui
+
+#endif // DUI_UPDATEQUEUE_HPP_
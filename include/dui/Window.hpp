@@ -62,7 +62,7 @@ public:
 
   ~WindowImpl()
   {
-    if (wrapper) {
+    if (!wrapper.isEnded()) {
       end();
     }
   }
@@ -70,7 +70,7 @@ public:
   /// Finishes the window
   void end()
   {
-    SDL_assert(wrapper);
+    SDL_assert(!wrapper.isEnded());
     auto sz = wrapper.end();
     auto rect = decoration.getRect();
     if (rect.w > 0) {
@@ -91,6 +91,14 @@ public:
   operator bool() const { return wrapper; }
 };
 
+#ifndef DUI_DEFINITIONS
+extern template class WindowImpl<Group>;
+extern template class WindowImpl<Scrollable>;
+#elif defined(DUI_COMPILED)
+template class WindowImpl<Group>;
+template class WindowImpl<Scrollable>;
+#endif
+
 /// Makes window size accordingly to parameters
 inline SDL_Point
 makeWindowSize(SDL_Point defaultSize, Target target)
@@ -205,8 +213,8 @@ scrollableWindow(
           id,
           title,
           makeScrollableRect(r, target),
-          [=](auto t, auto r) {
-            return scrollable(t, "client", scrollOffset, r, style);
+          [scrollOffset, client = ScrollableStyle(style)](auto t, auto r) {
+            return scrollable(t, "client", scrollOffset, r, client);
           },
           style};
 }
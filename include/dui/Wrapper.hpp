@@ -1,8 +1,10 @@
 #pragma once
 
 #include <functional>
+#include "Config.hpp"
 #include "EdgeSize.hpp"
 #include "Group.hpp"
+#include "InplaceFunction.hpp"
 
 namespace dui {
 
@@ -10,7 +12,12 @@ namespace dui {
 template<class CLIENT>
 class Wrapper : public Targetable<Wrapper<CLIENT>>
 {
+#ifdef DUI_BOUNDED_MEMORY
+  using ClientInitializer =
+    InplaceFunction<CLIENT(Target, const SDL_Rect&), DUI_MAX_INITIALIZER_SIZE>;
+#else
   using ClientInitializer = std::function<CLIENT(Target, const SDL_Rect&)>;
+#endif
   EdgeSize padding;
   ClientInitializer initializer;
   CLIENT client;
@@ -54,6 +61,9 @@ public:
   operator Target() & { return client; }
   operator bool() const { return valid && bool(client); }
 
+  /// True if end() was called. The client might refuse elements before that
+  bool isEnded() const { return !valid; }
+
   SDL_Point end();
 };
 
@@ -69,4 +79,10 @@ Wrapper<CLIENT>::end()
   return sz;
 }
 
+#ifndef DUI_DEFINITIONS
+extern template class Wrapper<Group>;
+#elif defined(DUI_COMPILED)
+template class Wrapper<Group>;
+#endif
+
 } // namespace dui
@@ -1,4 +1,4 @@
-unsigned char font_bmp[] = {
+inline unsigned char font_bmp[] = {
   0x42, 0x4d, 0x3e, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x00,
   0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x80, 0x00,
   0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08,
@@ -176,4 +176,4 @@ unsigned char font_bmp[] = {
   0xfd, 0xee, 0xf7, 0x7e, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x11, 0xaa,
   0x33, 0xaa, 0x00, 0xc3, 0xff, 0xee, 0x00, 0x00, 0x00, 0x00
 };
-unsigned int font_bmp_len = 2110;
+inline unsigned int font_bmp_len = 2110;
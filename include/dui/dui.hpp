@@ -1,22 +1,45 @@
 #ifndef DUI_HPP_
 #define DUI_HPP_
 
+#include "Animation.hpp"
 #include "Button.hpp"
+#include "ComboBox.hpp"
+#include "Config.hpp"
 #include "Dialogs.hpp"
 #include "DisplayList.hpp"
 #include "Element.hpp"
+#include "FileDialog.hpp"
+#include "Form.hpp"
 #include "Font.hpp"
+#include "Format.hpp"
 #include "Frame.hpp"
+#include "FrameArena.hpp"
+#include "FrameStats.hpp"
+#include "Geometry.hpp"
+#include "Governor.hpp"
 #include "Group.hpp"
+#include "Heatmap.hpp"
+#include "Histogram.hpp"
 #include "InputBox.hpp"
 #include "InputField.hpp"
+#include "Job.hpp"
+#include "JobBox.hpp"
 #include "Label.hpp"
+#include "LatencyHistogram.hpp"
 #include "Layer.hpp"
+#include "LineBreaks.hpp"
+#include "Memo.hpp"
+#include "MemoryStats.hpp"
+#include "NodeEditor.hpp"
+#include "OptionIndex.hpp"
 #include "Panel.hpp"
+#include "Parallel.hpp"
+#include "ProgressBar.hpp"
 #include "Scrollable.hpp"
 #include "SliderBox.hpp"
 #include "SliderField.hpp"
 #include "State.hpp"
+#include "Timeline.hpp"
 #include "Window.hpp"
 #include "Wrapper.hpp"
 
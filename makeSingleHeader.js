@@ -11,8 +11,27 @@ fs.writeSync(output, "\n */\n", undefined)
 fs.writeSync(output, "#ifndef DUI_SINGLE_HPP\n", undefined)
 fs.writeSync(output, "#define DUI_SINGLE_HPP\n\n", undefined)
 fs.writeSync(output, "#include <algorithm>\n", undefined)
+fs.writeSync(output, "#include <atomic>\n", undefined)
+fs.writeSync(output, "#include <charconv>\n", undefined)
+fs.writeSync(output, "#include <cmath>\n", undefined)
+fs.writeSync(output, "#include <condition_variable>\n", undefined)
+fs.writeSync(output, "#include <cstddef>\n", undefined)
+fs.writeSync(output, "#include <cstdint>\n", undefined)
+fs.writeSync(output, "#include <cstring>\n", undefined)
+fs.writeSync(output, "#include <deque>\n", undefined)
+fs.writeSync(output, "#include <filesystem>\n", undefined)
+fs.writeSync(output, "#include <functional>\n", undefined)
+fs.writeSync(output, "#include <iterator>\n", undefined)
+fs.writeSync(output, "#include <memory>\n", undefined)
+fs.writeSync(output, "#include <mutex>\n", undefined)
+fs.writeSync(output, "#include <new>\n", undefined)
+fs.writeSync(output, "#include <optional>\n", undefined)
 fs.writeSync(output, "#include <string>\n", undefined)
 fs.writeSync(output, "#include <string_view>\n", undefined)
+fs.writeSync(output, "#include <thread>\n", undefined)
+fs.writeSync(output, "#include <type_traits>\n", undefined)
+fs.writeSync(output, "#include <unordered_map>\n", undefined)
+fs.writeSync(output, "#include <utility>\n", undefined)
 fs.writeSync(output, "#include <vector>\n", undefined)
 fs.writeSync(output, "#include <SDL.h>\n\n", undefined)
 fs.writeSync(output, "namespace dui {\n\n", undefined)
@@ -23,8 +42,7 @@ fs.writeSync(output, "#endif\n\n", undefined)
 for (const fileName of fileQueue) {
   fs.writeSync(output, `// begin ${fileName}\n`)
   const content = fs.readFileSync(fileName, 'utf-8')
-  fs.writeSync(output, content
-    .replace(/^#.*$/gm, '')
+  fs.writeSync(output, stripPreprocessor(content)
     .replace(/^namespace dui \{$/gm, '')
     .replace(/^\} \/\/ namespace dui$/gm, '')
     .trim()
@@ -60,6 +78,20 @@ function makeQueue(file, queue) {
   return queue
 }
 
+/**
+ * Remove include guards, includes and pragmas, keeping other directives
+ * @param {string} content
+ */
+function stripPreprocessor(content) {
+  const guard = content.match(/^#ifndef (\w+)\n#define \1\n/m)
+  if (guard) {
+    content = content.replace(guard[0], '')
+    const last = content.lastIndexOf('\n#endif')
+    content = content.slice(0, last) + content.slice(last).replace(/^#endif.*$/m, '')
+  }
+  return content.replace(/^#(include|pragma) .*$/gm, '')
+}
+
 /**
  * 
  * @param {string} content 
@@ -0,0 +1,46 @@
+#include <string>
+#include <SDL.h>
+#include "dui.hpp"
+
+// A screen using the common elements. The compile_benchmark target builds it
+// with the header only and the compiled library, to compare their compile
+// times
+void
+benchmarkScreen(dui::State& state)
+{
+  static int clickCount = 0;
+  static bool toggleOption = false;
+  static int multiOption = 0;
+  static std::string str = "str";
+  static int value1 = 42;
+  static double value2 = 11.25;
+  static SDL_Point scrollOffset{0};
+  static SDL_Point windowOffset{0};
+
+  auto f = dui::frame(state);
+  dui::labelf(f, "{} clicks", clickCount);
+  if (auto w = dui::window(f, "Elements", {10, 10, 300, 580})) {
+    dui::label(w, "Hello world");
+    if (dui::button(w, "Click me!")) {
+      clickCount += 1;
+    }
+    dui::toggleButton(w, "Toggle", &toggleOption);
+    dui::choiceButton(w, "Option 1", &multiOption, 0);
+    dui::choiceButton(w, "Option 2", &multiOption, 1);
+    if (auto p = dui::panel(w, "group1")) {
+      dui::wrappedLabel(p, "A longer label, broken into lines", {0, 0, 120});
+      dui::button(p, "Grouped button");
+    }
+    if (auto p = dui::scrollablePanel(w, "group2", &scrollOffset)) {
+      dui::textField(p, "str", &str);
+      dui::numberField(p, "value1", &value1);
+      dui::numberField(p, "value2", &value2);
+    }
+  }
+  if (auto w = dui::scrollableWindow(f, "Scrolling", &windowOffset)) {
+    for (int i = 0; i < 10; ++i) {
+      dui::textf(w, {0, 10 * i}, "Line {}", i);
+    }
+  }
+  f.render();
+}
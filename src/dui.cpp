@@ -0,0 +1,12 @@
+/**
+ * @file dui.cpp
+ * @brief The translation unit of the compiled library
+ *
+ * It compiles the functions and instantiations the headers only declare when
+ * DUI_COMPILED is defined. @see Config.hpp
+ */
+#ifndef DUI_COMPILED
+#define DUI_COMPILED
+#endif
+#define DUI_IMPLEMENTATION
+#include "dui.hpp"